@@ -58,6 +58,7 @@ GBC_Graphics *GBC_Graphics_ctor(Window *window, uint8_t num_vram_banks, uint16_t
 
     self->lcdc = 0xFF; // Start LCDC with everything enabled (render everything)
     self->stat = 0x00; // Start STAT empty
+    GBC_Graphics_zoom_set_level(self, GBC_ZOOM_LEVEL_1X); // Start unzoomed
 
     return self;
 }
@@ -337,6 +338,9 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
     uint16_t byte;
     uint8_t bit;
     uint8_t *byte_mod;
+    uint8_t line_colors[256]; // The colors of the last rendered line before dithering, indexed by x
+#else
+    uint8_t *last_row_data = NULL;
 #endif
     
     uint8_t tile_x, tile_y;
@@ -347,6 +351,12 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
     short sprite_x, sprite_y;
     short sprite_id;
 
+    short src_x, src_y; // The position on the unzoomed screen that the pixel shows
+    short src_min_x, src_max_x;
+    int32_t src_x_fixed, src_y_fixed, src_step;
+    short last_src_y = 0;
+    uint8_t last_min_x = 0, last_max_x = 0;
+
     uint8_t sprites_on_this_line[GBC_NUM_SPRITES];
     uint8_t num_sprites_on_this_line;
     uint8_t sprite_line_index;
@@ -357,14 +367,48 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
     uint8_t background_start = self->num_backgrounds - 1;
     uint8_t sprite_layer_z;
 
-    uint8_t zoom_factor = ((self->zoom & GBC_ZOOM_LEVEL_MASK) >> GBC_ZOOM_LEVEL_SHIFT);
-    const uint8_t *zt = &ZOOM_TABLE[4 * zoom_factor];
+    // Zooming maps each pixel to a position on the unzoomed screen, which is stepped through in 16.16 fixed point
+    // so the only divide is this one per frame, src = center + (pixel - center) / scale
+    // Positions are taken from the middle of each pixel, half a step in, so rounding in the step can't cross onto the next unzoomed pixel
+    src_step = (1 << 24) / self->zoom_scale; // 1 / scale, from 8.8 to 16.16 fixed point
+    src_y_fixed = (self->zoom_center_y << 16) - self->zoom_center_y * src_step + (src_step >> 1);
 
     // Start by going through all of the rows
     for (self->line_y = 0; self->line_y < self->screen_height; self->line_y++) {
         GBitmapDataRowInfo info = gbitmap_get_data_row_info(fb, self->line_y + self->screen_y_origin);
         uint8_t min_x = GBC_MAX(info.min_x, self->screen_x_origin);
         uint8_t max_x = GBC_MIN(info.max_x+1, self->screen_x_origin + self->screen_width);
+
+        // Find the unzoomed line, and the unzoomed span of this line
+        src_y = src_y_fixed >> 16;
+        src_y_fixed += src_step;
+        src_x_fixed = (self->zoom_center_x << 16) + ((min_x - self->screen_x_origin) - self->zoom_center_x) * src_step + (src_step >> 1);
+        src_min_x = src_x_fixed >> 16;
+        src_max_x = (src_x_fixed + (max_x - 1 - min_x) * src_step) >> 16;
+
+        // Zoomed in, consecutive lines can show the same unzoomed line, so reuse the last line instead of rendering it again
+        if (self->line_y > 0 && src_y == last_src_y && min_x == last_min_x && max_x == last_max_x) {
+        #if defined(PBL_COLOR)
+            memcpy(&info.data[min_x], &last_row_data[min_x], max_x - min_x);
+        #else
+            // The dither pattern changes every line, so only the colors can be reused
+            for (x = min_x; x < max_x; x++) {
+                pixel_color = line_colors[x];
+                pixel_color = (pixel_color >> 1) & ((pixel_color & 1) | ((x + self->line_y) & 0b11));
+                byte = (x >> 3); // x / 8
+                bit = x & 7; // x % 8
+                byte_mod = &info.data[byte];
+                *byte_mod ^= (-pixel_color ^ *byte_mod) & (1 << bit);
+            }
+        #endif
+            continue;
+        }
+        last_src_y = src_y;
+        last_min_x = min_x;
+        last_max_x = max_x;
+    #if defined(PBL_COLOR)
+        last_row_data = info.data;
+    #endif
         
         sprite_layer_z = (self->lcdc & GBC_LCDC_SPRITE_LAYER_Z_MASK) >> GBC_LCDC_SPRITE_LAYER_Z_SHIFT;
         sprite_layer_z = GBC_MIN(sprite_layer_z, background_start);
@@ -372,29 +416,32 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
         for (sprite_id = 0; sprite_id < GBC_NUM_SPRITES; sprite_id++) {
             sprite = &self->oam[sprite_id * GBC_SPRITE_NUM_BYTES];
 
-            sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
+            sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X;
             sprite_y = sprite[GBC_OAM_Y_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_Y;
             sprite_w = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT)) << 3; // sprite_width * tile_width
             sprite_h = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT)) << 3; // sprite_height * tile_height
             
-            on_this_line = (self->line_y * zt[0] / zt[1] + self->screen_height * zt[2] / zt[3]) >= sprite_y && (self->line_y * zt[0] / zt[1] + self->screen_height * zt[2] / zt[3]) < (sprite_y + sprite_h)
+            on_this_line = src_y >= sprite_y && src_y < (sprite_y + sprite_h)
                             && (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_HIDE_FLAG) == 0 
-                            && sprite_x <= max_x && (sprite_x + sprite_w) >= min_x;
+                            && sprite_x <= src_max_x && (sprite_x + sprite_w) > src_min_x;
                             
             sprites_on_this_line[num_sprites_on_this_line] = sprite_id & BOOL_MASK[on_this_line];
             num_sprites_on_this_line += on_this_line;
         }
 
-        // Now for each pixel in the row:
-        for(x = min_x; x < max_x; x++) {
+        // Now for each unzoomed pixel in the row:
+        for (x = min_x; x < max_x;) {
             pixel_color = 0x00;
 
+            // Find the unzoomed pixel
+            src_x = src_x_fixed >> 16;
+
             // First draw the backgrounds below the sprite layer
             for (bg_num = 0; bg_num < self->num_backgrounds; bg_num++) {
                 if ((self->lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) continue;
 
-                map_x = ((x - self->screen_x_origin) * zt[0] / zt[1] + self->screen_width * zt[2] / zt[3]) + self->bg_scroll_x[bg_num];
-                map_y = (self->line_y * zt[0] / zt[1] + self->screen_height * zt[2] / zt[3]) + self->bg_scroll_y[bg_num];
+                map_x = src_x + self->bg_scroll_x[bg_num];
+                map_y = src_y + self->bg_scroll_y[bg_num];
                 
                 tilemap = self->bg_tilemaps + (bg_num << 10); // self->bg_tilemaps + bg_num * GBC_TILEMAP_NUM_BYTES
                 attrmap = self->bg_attrmaps + (bg_num << 10); // self->bg_attrmaps + bg_num * GBC_ATTRMAP_NUM_BYTES
@@ -448,15 +495,15 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
                 sprite = &self->oam[sprite_id*GBC_SPRITE_NUM_BYTES];
                 
                 // Check if the pixel we're rendering is within the sprite
-                sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X + self->screen_x_origin * zt[0] / zt[1];
+                sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X;
                 sprite_y = sprite[GBC_OAM_Y_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_Y;
                 sprite_w = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT)) << 3; // sprite_width * tile_width
                 sprite_h = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT)) << 3; // sprite_height * tile_height
 
                 // Find the pixel on the sprite
-                x_on_sprite = x * zt[0] / zt[1] + self->screen_width * zt[2] / zt[3] - sprite_x;
-                if ((x * zt[0] / zt[1] + self->screen_width * zt[2] / zt[3] < sprite_x) || (x_on_sprite >= sprite_w)) continue;
-                y_on_sprite = self->line_y * zt[0] / zt[1] + self->screen_height * zt[2] / zt[3] - sprite_y;
+                x_on_sprite = src_x - sprite_x;
+                if ((src_x < sprite_x) || (x_on_sprite >= sprite_w)) continue;
+                y_on_sprite = src_y - sprite_y;
                 
                 // Apply flip flags
                 flip_x = (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_FLIP_FLAG_X) >> 5; // Flip becomes 1
@@ -493,16 +540,21 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
                 if (pixel != 0) break;
             }
 
-        #if defined(PBL_COLOR)
-            memset(&info.data[x], pixel_color, 1);
-        #else
-            pixel_color = (pixel_color >> 1) & ((pixel_color & 1) | ((x + self->line_y) & 0b11));
-            byte = (x >> 3); // x / 8
-            bit = x & 7; // x % 8
-            byte_mod = &info.data[byte];
-            *byte_mod ^= (-pixel_color ^ *byte_mod) & (1 << bit);
-        #endif
-
+            // Zoomed in, the pixels after this one can show the same unzoomed pixel, so draw the whole run with this color
+            do {
+            #if defined(PBL_COLOR)
+                info.data[x] = pixel_color;
+            #else
+                line_colors[x] = pixel_color;
+                new_pixel_color = (pixel_color >> 1) & ((pixel_color & 1) | ((x + self->line_y) & 0b11));
+                byte = (x >> 3); // x / 8
+                bit = x & 7; // x % 8
+                byte_mod = &info.data[byte];
+                *byte_mod ^= (-new_pixel_color ^ *byte_mod) & (1 << bit);
+            #endif
+                x++;
+                src_x_fixed += src_step;
+            } while (x < max_x && (src_x_fixed >> 16) == src_x);
         }
     }
 
@@ -552,7 +604,17 @@ void GBC_Graphics_alpha_mode_set_mode(GBC_Graphics *self, uint8_t bg_num, uint8_
 }
 
 void GBC_Graphics_zoom_set_level(GBC_Graphics *self, uint8_t level) {
-    modify_byte(&self->zoom, GBC_ZOOM_LEVEL_MASK, level, GBC_ZOOM_LEVEL_START);
+    GBC_Graphics_zoom_set_scale(self, (level + 1) * GBC_ZOOM_SCALE_ONE);
+    GBC_Graphics_zoom_set_center(self, self->screen_width >> 1, self->screen_height >> 1);
+}
+
+void GBC_Graphics_zoom_set_scale(GBC_Graphics *self, uint16_t scale) {
+    self->zoom_scale = GBC_MAX(scale, GBC_ZOOM_SCALE_MIN);
+}
+
+void GBC_Graphics_zoom_set_center(GBC_Graphics *self, uint8_t center_x, uint8_t center_y) {
+    self->zoom_center_x = center_x;
+    self->zoom_center_y = center_y;
 }
 
 uint8_t GBC_Graphics_stat_get_current_line(GBC_Graphics *self) {
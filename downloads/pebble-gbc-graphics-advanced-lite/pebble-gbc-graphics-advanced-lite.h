@@ -113,26 +113,14 @@
 #define GBC_ALPHA_MODE_OR 5       ///> Alpha Mode OR - ORs the alpha layer colors with current colors
 #define GBC_ALPHA_MODE_XOR 6      ///> Alpha Mode XOR - XORs the alpha layer colors with current colors
 
-/** Zoom Level flags */
-#define GBC_ZOOM_LEVEL_MASK 0x3     ///> Mask for zoom level
-#define GBC_ZOOM_LEVEL_SHIFT 0      ///> Shift for zoom level
-#define GBC_ZOOM_LEVEL_START 0x01    ///> LSB of the OAM sprite width
+/** Zoom scales */
+#define GBC_ZOOM_SCALE_ONE 0x0100 ///> 1x zoom in the 8.8 fixed point format of the zoom scale
+#define GBC_ZOOM_SCALE_MIN 0x0020 ///> The smallest zoom scale, 1/8x
 /** Zoom levels */
 #define GBC_ZOOM_LEVEL_1X 0   ///> 1x zoom level
-#define GBC_ZOOM_LEVEL_2X 4   ///> 2x zoom level
-#define GBC_ZOOM_LEVEL_3X 5   ///> 3x zoom level
-#define GBC_ZOOM_LEVEL_4X 6   ///> 4x zoom level
-/** Zoom table
- * E.g. for 2x zoom level:
- *    (x * 1 / 2 - screen_x_origin + screen_width * 1 / 4) + scroll_x + screen_x_origin * 1 / 4;
- * -> (x * ZT[4 * 4 + 0] / ZT[4 * 4 + 1] - screen_x_origin + screen_width * ZT[4 * 4 + 2] / ZT[4 * 4 + 3]) + scroll_x + screen_x_origin * ZT[4 * 4 + 2] / ZT[4 * 4 + 3]
- */
-static const uint8_t ZOOM_TABLE[] = { ///> Table for each zoom level
-    1, 1, 0, 1,  ///> 1x zoom level
-    1, 2, 1, 4,  ///> 2x zoom level
-    1, 3, 1, 3,  ///> 3x zoom level
-    1, 4, 3, 8   ///> 4x zoom level
-};
+#define GBC_ZOOM_LEVEL_2X 1   ///> 2x zoom level
+#define GBC_ZOOM_LEVEL_3X 2   ///> 3x zoom level
+#define GBC_ZOOM_LEVEL_4X 3   ///> 4x zoom level
 
 /** STAT flags */
 #define GBC_STAT_HBLANK_FLAG 0x01        ///> Flag for STAT HBlank flag bit
@@ -173,8 +161,6 @@ static const uint8_t ZOOM_TABLE[] = { ///> Table for each zoom level
 #define GBC_GET_GREEN(c) (((c) >> 2) & 0b11)
 #define GBC_GET_BLUE(c) (((c) >> 0) & 0b11)
 #define GBC_MAKE_COLOR(r, g, b) (0b11000000 | ((r) << 4) | ((g) << 2) | ((b) << 0))
-#define GBC_ZOOM_DIV(x, a, b) ((x) * (a) / (b))
-#define GBC_ZOOM_MULT(x, z) ((x) << (z))
 
 /** Predefined Screen boundaries for convenience*/
 #if defined(PBL_ROUND)
@@ -243,11 +229,13 @@ struct _gbc_graphics {
     */
     uint16_t a_mode;
     /**
-     * The Zoom byte
-     *  -Bits 0-1: Zoom level (2^level, e.g. level 2 == 4x zoom), 0-3
-     *  -Bits 2-7: Reserved
+     * The Zoom Scale - How much the screen is zoomed in, in 8.8 fixed point
+     * e.g. GBC_ZOOM_SCALE_ONE is 1x, GBC_ZOOM_SCALE_ONE * 3 / 2 is 1.5x
+     * The renderer steps through the zoomed coordinates with adds, so any scale costs the same to draw
      */
-    uint8_t zoom;
+    uint16_t zoom_scale;
+    uint8_t zoom_center_x; ///> The x position on the screen that stays in place when zooming
+    uint8_t zoom_center_y; ///> The y position on the screen that stays in place when zooming
     /**
      * VRAM Buffer - Stores the tiles for the backgrounds and sprites in a 4bpp format
      * Originally, the VRAM contained 4 banks of 8192 bytes, for a total of 32768 bytes
@@ -723,13 +711,30 @@ void GBC_Graphics_alpha_mode_set_bg_enabled(GBC_Graphics *self, uint8_t bg_num,
 void GBC_Graphics_alpha_mode_set_mode(GBC_Graphics *self, uint8_t bg_num, uint8_t mode);
 
 /**
- * Sets the zoom level
+ * Sets the zoom level, zooming around the center of the current screen bounds
  * 
  * @param self A pointer to the target GBC Graphics object
- * @param level The zoom level, 0-3
+ * @param level The zoom level, 0-3 for 1x-4x
  */
 void GBC_Graphics_zoom_set_level(GBC_Graphics *self, uint8_t level);
 
+/**
+ * Sets the zoom scale
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param scale The zoom scale in 8.8 fixed point, GBC_ZOOM_SCALE_ONE for 1x, at least GBC_ZOOM_SCALE_MIN
+ */
+void GBC_Graphics_zoom_set_scale(GBC_Graphics *self, uint16_t scale);
+
+/**
+ * Sets the point on the screen that stays in place when zooming
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param center_x The x position on the screen, relative to the screen x origin
+ * @param center_y The y position on the screen, relative to the screen y origin
+ */
+void GBC_Graphics_zoom_set_center(GBC_Graphics *self, uint8_t center_x, uint8_t center_y);
+
 /**
  * Gets the current line being rendered
  * 
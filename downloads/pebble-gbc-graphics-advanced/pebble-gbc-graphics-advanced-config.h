@@ -0,0 +1,35 @@
+#pragma once         ///> Prevent errors by being included multiple times
+
+/**
+ * Build time options for the GBC Graphics engine, which compile out the features an app doesn't use
+ * Change the values here, or define them for the whole project in the wscript, e.g.
+ *     ctx.env.append_value('DEFINES', ['GBC_CONFIG_ALPHA=0'])
+ * @file pebble-gbc-graphics-advanced-config.h
+ * @author Harrison Allen
+ * @version 1.6.0 10/19/2026
+ */
+
+/**
+ * The max number of background layers, from 1-4
+ * The renderer's per line arrays are sized by this, and the constructors clamp num_backgrounds to it
+ */
+#ifndef GBC_CONFIG_MAX_BACKGROUNDS
+#define GBC_CONFIG_MAX_BACKGROUNDS 4
+#endif
+
+/**
+ * Set to 0 to compile out the alpha modes, so every background draws in normal mode
+ * The alpha mode register is left out of the object, and the alpha mode functions are kept, but have no effect
+ */
+#ifndef GBC_CONFIG_ALPHA
+#define GBC_CONFIG_ALPHA 1
+#endif
+
+/**
+ * Set to 0 to compile out background and sprite mosaic, so every layer draws at full resolution
+ * The background mosaic registers and the decoded sprite mosaic arrays are left out of the object,
+ * and the mosaic functions are kept, but have no effect
+ */
+#ifndef GBC_CONFIG_MOSAIC
+#define GBC_CONFIG_MOSAIC 1
+#endif
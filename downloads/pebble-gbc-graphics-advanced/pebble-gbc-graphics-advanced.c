@@ -3,14 +3,265 @@
 
 const uint16_t BOOL_MASK[2] = {0x0000, 0xFFFF};
 
+#if defined(PBL_BW)
+/**
+ * The dither patterns as rows of 8 pixels, for each dither mode and color, on each line mod 4
+ * Bit n of a row is white for framebuffer x mod 8 == n
+ */
+static const uint8_t DITHER_ROW_MASKS[GBC_NUM_DITHER_MODES << 2][4] = {
+    // Checker
+    {0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00}, {0xAA, 0x55, 0xAA, 0x55}, {0xFF, 0xFF, 0xFF, 0xFF},
+    // Bayer
+    {0x00, 0x00, 0x00, 0x00}, {0x55, 0x00, 0x55, 0x00}, {0x55, 0xAA, 0x55, 0xAA}, {0xFF, 0xFF, 0xFF, 0xFF},
+    // Lines
+    {0x00, 0x00, 0x00, 0x00}, {0x00, 0xFF, 0x00, 0x00}, {0x00, 0xFF, 0x00, 0xFF}, {0xFF, 0xFF, 0xFF, 0xFF},
+    // None
+    {0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00}, {0xFF, 0xFF, 0xFF, 0xFF}, {0xFF, 0xFF, 0xFF, 0xFF},
+};
+#endif
+
+///> The format of the framebuffer, which the bitmaps rendered into must match
+#if defined(PBL_BW)
+#define GBC_FRAMEBUFFER_FORMAT GBitmapFormat1Bit
+#elif defined(PBL_ROUND)
+#define GBC_FRAMEBUFFER_FORMAT GBitmapFormat8BitCircular
+#else
+#define GBC_FRAMEBUFFER_FORMAT GBitmapFormat8Bit
+#endif
+
 ///> Forward declarations for static functions
 static void graphics_update_proc(Layer *layer, GContext *ctx);
+static void invalidate_bg_caches(GBC_Graphics *self, uint8_t bg_flags);
+static void allocate_bg_cache(GBC_Graphics *self, uint8_t bg_layer);
+static void update_tile_masks(GBC_Graphics *self, uint16_t first_tile_number, uint16_t num_tiles);
 
 GBC_Graphics *GBC_Graphics_ctor(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds) { 
-    GBC_Graphics *self = NULL;
-    self = malloc(sizeof(GBC_Graphics));
-    if (self == NULL)
+    return GBC_Graphics_ctor_with_num_sprites(window, num_vram_banks, num_backgrounds, GBC_NUM_SPRITES);
+}
+
+/**
+ * Gets a background's map size, kept within the supported sizes
+ * 
+ * @param map_sizes An array of map sizes, or NULL for 32 x 32 maps
+ * @param bg_layer The number of the background layer
+ * 
+ * @return The map size, with each side from 16 to 128 tiles and at most 4096 tiles in total, and its wide tiles flag
+ */
+static uint8_t get_map_size(const uint8_t *map_sizes, uint8_t bg_layer) {
+    uint8_t map_size = map_sizes == NULL ? GBC_MAP_SIZE_32X32 : map_sizes[bg_layer];
+    uint8_t width_shift = GBC_MAX(GBC_MIN((map_size & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT, GBC_MAP_MAX_SHIFT), GBC_MAP_MIN_SHIFT);
+    uint8_t height_shift = GBC_MAX(GBC_MIN(map_size & GBC_MAP_SIZE_HEIGHT_MASK, GBC_MAP_MAX_SHIFT), GBC_MAP_MIN_SHIFT);
+    height_shift = GBC_MIN(height_shift, GBC_MAP_MAX_AREA_SHIFT - width_shift); // Too many tiles, so the map gets shorter
+    return GBC_MAP_SIZE(width_shift, height_shift) | (map_size & GBC_MAP_WIDE_TILES_FLAG);
+}
+
+/**
+ * Gets the number of tiles in a map
+ * 
+ * @param map_size The size of the map
+ * 
+ * @return The number of tiles, which is also the number of bytes in its attrmap
+ */
+static uint16_t get_map_num_tiles(uint8_t map_size) {
+    return 1 << (((map_size & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT) + (map_size & GBC_MAP_SIZE_HEIGHT_MASK)); // width * height
+}
+
+/**
+ * Gets the number of bytes in a map's tilemap
+ * 
+ * @param map_size The size of the map
+ * 
+ * @return The number of bytes, 2 per tile for wide maps and 1 per tile otherwise
+ */
+static uint16_t get_tilemap_num_bytes(uint8_t map_size) {
+    return get_map_num_tiles(map_size) << ((map_size & GBC_MAP_WIDE_TILES_FLAG) != 0);
+}
+
+/**
+ * Takes the next block out of an arena, keeping every block aligned for the largest type in it
+ * 
+ * @param arena A pointer to the start of the arena, or NULL when only measuring it
+ * @param arena_used A pointer to the number of bytes taken so far, which is moved past the block
+ * @param num_bytes The size of the block
+ * 
+ * @return A pointer to the block, or NULL when only measuring
+ */
+static void *arena_take(uint8_t *arena, size_t *arena_used, size_t num_bytes) {
+    void *block = arena == NULL ? NULL : arena + *arena_used;
+    *arena_used += (num_bytes + GBC_ARENA_ALIGNMENT - 1) & ~(GBC_ARENA_ALIGNMENT - 1); // Round up to the alignment
+    return block;
+}
+
+/**
+ * Lays out the object and all of its buffers in one arena, in roughly the order the renderer reads them
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param arena A pointer to the arena to lay the buffers out in, or NULL to only measure it
+ * @param num_vram_banks The number of vram banks
+ * @param num_backgrounds The number of background layers
+ * @param num_sprites The number of sprite slots in OAM
+ * @param map_sizes An array of num_backgrounds map sizes, or NULL for 32 x 32 maps
+ * 
+ * @return The number of bytes the object and its buffers take up
+ */
+static size_t layout_arena(GBC_Graphics *self, uint8_t *arena, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, 
+                           const uint8_t *map_sizes) {
+    size_t arena_used = 0;
+    uint16_t sprite_bin_words = (num_sprites + 31) >> 5; // ceil(num_sprites / 32)
+    uint16_t map_num_tiles = 0, tilemap_num_bytes = 0;
+    for (uint8_t bg_layer = 0; bg_layer < num_backgrounds; bg_layer++) {
+        map_num_tiles += get_map_num_tiles(get_map_size(map_sizes, bg_layer));
+        tilemap_num_bytes += get_tilemap_num_bytes(get_map_size(map_sizes, bg_layer));
+    }
+
+    // The object itself goes first, so it's the pointer that gets freed
+    arena_take(arena, &arena_used, sizeof(GBC_Graphics));
+
+    // Then what every line reads: the sprite bins, the line's scratch lists, and the decoded sprites
+    self->sprite_bins = (uint32_t*)arena_take(arena, &arena_used, GBC_SPRITE_NUM_BINS * sprite_bin_words * sizeof(uint32_t));
+    self->line_sprites = (uint16_t*)arena_take(arena, &arena_used, num_sprites * sizeof(uint16_t));
+    self->line_sprite_steps = (GBC_Line_Step*)arena_take(arena, &arena_used, num_sprites * sizeof(GBC_Line_Step));
+    self->line_bg_steps = (GBC_Line_Step*)arena_take(arena, &arena_used, num_backgrounds * sizeof(GBC_Line_Step));
+    self->sprite_cache.tiles = (uint8_t**)arena_take(arena, &arena_used, num_sprites * sizeof(uint8_t*));
+    self->sprite_cache.x = (short*)arena_take(arena, &arena_used, num_sprites * sizeof(short));
+    self->sprite_cache.y = (short*)arena_take(arena, &arena_used, num_sprites * sizeof(short));
+    self->sprite_cache.width = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_cache.height = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_cache.palette_offsets = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_cache.attrs = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+#if GBC_CONFIG_MOSAIC
+    self->sprite_cache.mosaic_x = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_cache.mosaic_y = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+#endif
+    self->sprite_cache.affine_matrix = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_cache.size_shift = (uint8_t*)arena_take(arena, &arena_used, num_sprites);
+    self->sprite_affine_matrices = (int16_t*)arena_take(arena, &arena_used, GBC_SPRITE_NUM_AFFINE_MATRICES * GBC_AFFINE_MATRIX_NUM_VALUES * sizeof(int16_t));
+
+    // The background registers, read at the start of every line
+    self->bg_map_sizes = (uint8_t*)arena_take(arena, &arena_used, num_backgrounds);
+    self->bg_tilemap_offsets = (uint16_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(uint16_t));
+    self->bg_attrmap_offsets = (uint16_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(uint16_t));
+    self->bg_scroll_x = (short*)arena_take(arena, &arena_used, num_backgrounds * sizeof(short));
+    self->bg_scroll_y = (short*)arena_take(arena, &arena_used, num_backgrounds * sizeof(short));
+    self->bg_affine_params = (int16_t*)arena_take(arena, &arena_used, num_backgrounds * GBC_AFFINE_MATRIX_NUM_VALUES * sizeof(int16_t));
+    self->bg_affine_ref_x = (int32_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(int32_t));
+    self->bg_affine_ref_y = (int32_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(int32_t));
+    self->bg_affine_line_x = (int32_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(int32_t));
+    self->bg_affine_line_y = (int32_t*)arena_take(arena, &arena_used, num_backgrounds * sizeof(int32_t));
+#if GBC_CONFIG_MOSAIC
+    self->bg_mosaic = (uint8_t*)arena_take(arena, &arena_used, num_backgrounds);
+#endif
+    self->bg_caches = (uint8_t**)arena_take(arena, &arena_used, num_backgrounds * sizeof(uint8_t*));
+    self->bg_direct_images = (GBC_Direct_Image*)arena_take(arena, &arena_used, num_backgrounds * sizeof(GBC_Direct_Image));
+
+    // The palettes, faded ones first since those are what the pixels read
+    self->bg_faded_palette_bank = (uint8_t*)arena_take(arena, &arena_used, GBC_PALETTE_BANK_NUM_BYTES);
+    self->sprite_faded_palette_bank = (uint8_t*)arena_take(arena, &arena_used, GBC_PALETTE_BANK_NUM_BYTES);
+    self->bg_palette_bank = (uint8_t*)arena_take(arena, &arena_used, GBC_PALETTE_BANK_NUM_BYTES);
+    self->sprite_palette_bank = (uint8_t*)arena_take(arena, &arena_used, GBC_PALETTE_BANK_NUM_BYTES);
+
+    // The maps and the tiles they point into
+    self->bg_tilemaps = (uint8_t*)arena_take(arena, &arena_used, tilemap_num_bytes);
+    self->bg_attrmaps = (uint8_t*)arena_take(arena, &arena_used, map_num_tiles);
+    self->vram = (uint8_t*)arena_take(arena, &arena_used, GBC_VRAM_BANK_NUM_BYTES * num_vram_banks);
+
+    // And last, what's only read when it changes or between frames
+    self->oam = (uint8_t*)arena_take(arena, &arena_used, num_sprites * GBC_SPRITE_NUM_BYTES);
+    self->palette_animations = (GBC_Palette_Animation*)arena_take(arena, &arena_used, GBC_NUM_PALETTE_ANIMATIONS * sizeof(GBC_Palette_Animation));
+
+    return arena_used;
+}
+
+/**
+ * Takes a render copy of a shadowed register out of the shadow buffer, and copies the register into it
+ * 
+ * @param shadow_buffer A pointer to the shadow buffer, or NULL when shadowing is disabled
+ * @param shadow_used A pointer to the number of bytes of the shadow buffer used so far, which is increased
+ * @param source A pointer to the register
+ * @param num_bytes The size of the register
+ * 
+ * @return A pointer to the render copy, or the register itself when shadowing is disabled
+ */
+static void *take_render_copy(uint8_t *shadow_buffer, size_t *shadow_used, void *source, size_t num_bytes) {
+    void *copy = arena_take(shadow_buffer, shadow_used, num_bytes);
+    if (copy == NULL) return source; // Not shadowed, so the renderer reads the register directly
+    memcpy(copy, source, num_bytes);
+    return copy;
+}
+
+/**
+ * Points the renderer at the render copies of the shadowed registers, copying the registers into them
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param shadow_buffer A pointer to the shadow buffer to lay the copies out in, or NULL to point the renderer at the registers themselves
+ * 
+ * @return The number of bytes the render copies take up
+ */
+static size_t layout_render_copies(GBC_Graphics *self, uint8_t *shadow_buffer) {
+    size_t shadow_used = 0;
+    uint16_t num_sprites = self->num_sprites;
+    GBC_Sprite_Cache *cache = &self->sprite_cache, *render_cache = &self->render_sprite_cache;
+
+    // The sprites, as the renderer reads them: binned and decoded
+    self->render_sprite_bins = (uint32_t*)take_render_copy(shadow_buffer, &shadow_used, self->sprite_bins, GBC_SPRITE_NUM_BINS * self->sprite_bin_words * sizeof(uint32_t));
+    render_cache->tiles = (uint8_t**)take_render_copy(shadow_buffer, &shadow_used, cache->tiles, num_sprites * sizeof(uint8_t*));
+    render_cache->x = (short*)take_render_copy(shadow_buffer, &shadow_used, cache->x, num_sprites * sizeof(short));
+    render_cache->y = (short*)take_render_copy(shadow_buffer, &shadow_used, cache->y, num_sprites * sizeof(short));
+    render_cache->width = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->width, num_sprites);
+    render_cache->height = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->height, num_sprites);
+    render_cache->palette_offsets = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->palette_offsets, num_sprites);
+    render_cache->attrs = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->attrs, num_sprites);
+#if GBC_CONFIG_MOSAIC
+    render_cache->mosaic_x = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->mosaic_x, num_sprites);
+    render_cache->mosaic_y = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->mosaic_y, num_sprites);
+#endif
+    render_cache->affine_matrix = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->affine_matrix, num_sprites);
+    render_cache->size_shift = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, cache->size_shift, num_sprites);
+    self->render_sprite_affine_matrices = (int16_t*)take_render_copy(shadow_buffer, &shadow_used, self->sprite_affine_matrices, 
+                                                                     GBC_SPRITE_NUM_AFFINE_MATRICES * GBC_AFFINE_MATRIX_NUM_VALUES * sizeof(int16_t));
+
+    // Then the background and palette registers
+    self->render_bg_scroll_x = (short*)take_render_copy(shadow_buffer, &shadow_used, self->bg_scroll_x, self->num_backgrounds * sizeof(short));
+    self->render_bg_scroll_y = (short*)take_render_copy(shadow_buffer, &shadow_used, self->bg_scroll_y, self->num_backgrounds * sizeof(short));
+    self->render_bg_palette_bank = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, self->bg_palette_bank, GBC_PALETTE_BANK_NUM_BYTES);
+    self->render_sprite_palette_bank = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, self->sprite_palette_bank, GBC_PALETTE_BANK_NUM_BYTES);
+    self->render_lcdc = (uint8_t*)take_render_copy(shadow_buffer, &shadow_used, &self->lcdc, sizeof(self->lcdc));
+
+    return shadow_used;
+}
+
+size_t GBC_Graphics_get_footprint(uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, const uint8_t *map_sizes) {
+    GBC_Graphics layout; // Only measuring, so the pointers are never used
+    num_backgrounds = GBC_MIN(num_backgrounds, GBC_MAX_NUM_BACKGROUNDS);
+    return layout_arena(&layout, NULL, num_vram_banks, num_backgrounds, num_sprites, map_sizes);
+}
+
+GBC_Graphics *GBC_Graphics_ctor_with_num_sprites(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites) { 
+    return GBC_Graphics_ctor_with_map_sizes(window, num_vram_banks, num_backgrounds, num_sprites, NULL);
+}
+
+GBC_Graphics *GBC_Graphics_ctor_with_map_sizes(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, const uint8_t *map_sizes) { 
+    // Allocate the object and all of its buffers at once
+    void *buffer = malloc(GBC_Graphics_get_footprint(num_vram_banks, num_backgrounds, num_sprites, map_sizes));
+    if (buffer == NULL)
+        return NULL;
+
+    GBC_Graphics *self = GBC_Graphics_ctor_in_buffer(window, num_vram_banks, num_backgrounds, num_sprites, map_sizes, buffer);
+    self->owns_buffer = true; // The buffer came from here, so destroy frees it
+    return self;
+}
+
+GBC_Graphics *GBC_Graphics_ctor_in_buffer(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, 
+                                          const uint8_t *map_sizes, void *buffer) { 
+    if (buffer == NULL)
         return NULL;
+    num_backgrounds = GBC_MIN(num_backgrounds, GBC_MAX_NUM_BACKGROUNDS); // The renderer only has room for this many
+
+    // Clear the buffer and lay the object and its buffers out in it, so there's nothing left to allocate
+    memset(buffer, 0, GBC_Graphics_get_footprint(num_vram_banks, num_backgrounds, num_sprites, map_sizes));
+    GBC_Graphics *self = (GBC_Graphics*)buffer;
+    layout_arena(self, (uint8_t*)buffer, num_vram_banks, num_backgrounds, num_sprites, map_sizes);
+    self->owns_buffer = false;
     
     // Initialize the bg/window and sprite layers
     Layer *window_layer = window_get_root_layer(window);
@@ -26,42 +277,74 @@ GBC_Graphics *GBC_Graphics_ctor(Window *window, uint8_t num_vram_banks, uint8_t
     self->screen_width = bounds.size.w;
     self->screen_height = bounds.size.h;
 
-    // Allocate banks of VRAM space
-    self->vram = (uint8_t*)malloc(GBC_VRAM_BANK_NUM_BYTES * num_vram_banks);
-
-    // Allocate space for the tilemaps and attributemaps
-    self->bg_tilemaps = (uint8_t*)malloc(GBC_TILEMAP_NUM_BYTES * num_backgrounds);
-    self->bg_attrmaps = (uint8_t*)malloc(GBC_ATTRMAP_NUM_BYTES * num_backgrounds);
-
-    // Allocate space for the palette banks
-    self->bg_palette_bank = (uint8_t*)malloc(GBC_PALETTE_BANK_NUM_BYTES);
-    self->sprite_palette_bank = (uint8_t*)malloc(GBC_PALETTE_BANK_NUM_BYTES);
+    // No palette animations are running, and nothing has been rendered yet
+    self->dirty_palettes = 0xFFFF;
+    self->fade_dirty_palettes = 0xFFFF;
 
+    // Start every background unchanged, with no mosaic, caching, or direct color
     self->num_backgrounds = num_backgrounds;
-    self->bg_scroll_x = (short*)malloc(num_backgrounds * sizeof(short));
-    self->bg_scroll_y = (short*)malloc(num_backgrounds * sizeof(short));
+    self->num_vram_banks = num_vram_banks;
+    self->bg_affine = 0x00;
+    self->bg_cached = 0x00;
+    self->bg_cache_valid = 0x00;
+    self->bg_cache_filling = 0x00;
+    self->bg_direct_color = 0x00;
+    self->line_direct_pixels = NULL; // Allocated once a background uses direct color
+    self->tile_collision_flags = NULL; // Allocated once a tile's collision flags are set
+    self->tile_masks = NULL; // Allocated once the tile masks are enabled
+    uint16_t tilemap_offset = 0, attrmap_offset = 0;
+    for (uint8_t bg_layer = 0; bg_layer < num_backgrounds; bg_layer++) {
+        // Each background's maps follow the last one's, every map is at least 256 tiles so wide tilemaps stay aligned
+        self->bg_map_sizes[bg_layer] = get_map_size(map_sizes, bg_layer);
+        self->bg_tilemap_offsets[bg_layer] = tilemap_offset;
+        self->bg_attrmap_offsets[bg_layer] = attrmap_offset;
+        tilemap_offset += get_tilemap_num_bytes(self->bg_map_sizes[bg_layer]);
+        attrmap_offset += get_map_num_tiles(self->bg_map_sizes[bg_layer]);
+        GBC_Graphics_bg_set_affine_params(self, bg_layer, GBC_AFFINE_ONE, 0, 0, GBC_AFFINE_ONE);
+        GBC_Graphics_bg_set_affine_ref_point(self, bg_layer, 0, 0);
+    }
 
-    // Allocate space for the OAM
-    self->oam = (uint8_t*)malloc(GBC_OAM_NUM_BYTES);
+    // Start with every sprite offscreen, and every affine matrix as the identity
+    self->num_sprites = num_sprites;
+    self->sprite_bin_words = (num_sprites + 31) >> 5; // ceil(num_sprites / 32)
+    for (uint8_t matrix_num = 0; matrix_num < GBC_SPRITE_NUM_AFFINE_MATRICES; matrix_num++) {
+        GBC_Graphics_oam_set_affine_matrix(self, matrix_num, GBC_AFFINE_ONE, 0, 0, GBC_AFFINE_ONE);
+    }
 
     self->lcdc = 0xFF; // Start LCDC with everything enabled (render everything)
     self->stat = 0x00; // Start STAT empty
 
+    self->fade_targets = GBC_FADE_BG_FLAG | GBC_FADE_SPRITE_FLAG;
+    self->fade_amount = 0; // Start with no fade
+    self->fade_color = 0x00;
+
+    self->dither_mode = 0x0000; // Start every layer with the checker dither
+
+    self->sprite_line_limit = 0; // Start with no limit on sprites per line
+    self->sprite_flicker_enabled = false;
+    self->sprite_flicker_offset = 0;
+
+    self->shadow_buffer = NULL; // Start unshadowed, so the renderer reads the registers directly
+    layout_render_copies(self, NULL);
+
+    GBC_Graphics_oam_sync(self); // Decode the empty OAM into the sprite cache
+
     return self;
 }
 
 void GBC_Graphics_destroy(GBC_Graphics *self) {
-    free(self->vram);
-    free(self->oam);
-    free(self->bg_tilemaps);
-    free(self->bg_attrmaps);
-    free(self->bg_palette_bank);
-    free(self->sprite_palette_bank);
-    free(self->bg_scroll_x);
-    free(self->bg_scroll_y);
-    layer_destroy(self->graphics_layer);
     if (self == NULL) return;
-        free(self);
+    free(self->line_direct_pixels);
+    free(self->shadow_buffer);
+    free(self->tile_collision_flags);
+    free(self->tile_masks);
+    for (uint8_t bg_layer = 0; bg_layer < self->num_backgrounds; bg_layer++) {
+        free(self->bg_caches[bg_layer]);
+    }
+    layer_destroy(self->graphics_layer);
+    if (self->owns_buffer) {
+        free(self); // Everything else lives in the same buffer
+    }
 }
 
 void GBC_Graphics_set_screen_bounds(GBC_Graphics *self, GRect bounds) {
@@ -70,22 +353,33 @@ void GBC_Graphics_set_screen_bounds(GBC_Graphics *self, GRect bounds) {
     self->screen_width = bounds.size.w;
     self->screen_height = bounds.size.h;
     layer_set_frame(self->graphics_layer, bounds);
+    for (uint8_t bg_layer = 0; bg_layer < self->num_backgrounds; bg_layer++) {
+        allocate_bg_cache(self, bg_layer); // Resize the caches to the new screen
+    }
 }
 
 void GBC_Graphics_set_screen_x_origin(GBC_Graphics *self, uint8_t new_x) {
     self->screen_x_origin = new_x;
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
 }
 
 void GBC_Graphics_set_screen_y_origin(GBC_Graphics *self, uint8_t new_y) {
     self->screen_y_origin = new_y;
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
 }
 
 void GBC_Graphics_set_screen_width(GBC_Graphics *self, uint8_t new_width) {
     self->screen_width = new_width;
+    for (uint8_t bg_layer = 0; bg_layer < self->num_backgrounds; bg_layer++) {
+        allocate_bg_cache(self, bg_layer); // Resize the caches to the new screen
+    }
 }
 
 void GBC_Graphics_set_screen_height(GBC_Graphics *self, uint8_t new_height) {
     self->screen_height = new_height;
+    for (uint8_t bg_layer = 0; bg_layer < self->num_backgrounds; bg_layer++) {
+        allocate_bg_cache(self, bg_layer); // Resize the caches to the new screen
+    }
 }
 
 GRect GBC_Graphics_get_screen_bounds(GBC_Graphics *self) {
@@ -121,6 +415,9 @@ void GBC_Graphics_vram_move_tiles(GBC_Graphics *self, uint8_t src_vram_bank, uin
     } else {
         memcpy(dest_vram_offset, src_vram_offset, data_size);
     }
+    update_tile_masks(self, (src_vram_bank << 8) + src_tile_offset, num_tiles_to_move);
+    update_tile_masks(self, (dest_vram_bank << 8) + dest_tile_offset, num_tiles_to_move);
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
 }
 
 void GBC_Graphics_load_from_tilesheet_into_vram(GBC_Graphics *self, uint32_t tilesheet_resource, uint16_t tilesheet_tile_offset, 
@@ -129,12 +426,16 @@ void GBC_Graphics_load_from_tilesheet_into_vram(GBC_Graphics *self, uint32_t til
     uint8_t *vram_offset = self->vram + GBC_VRAM_BANK_NUM_BYTES * vram_bank_number + vram_tile_offset * GBC_TILE_NUM_BYTES;
     
     resource_load_byte_range(tilesheet_handle, tilesheet_tile_offset * GBC_TILE_NUM_BYTES, vram_offset, tiles_to_load * GBC_TILE_NUM_BYTES);
+    update_tile_masks(self, (vram_bank_number << 8) + vram_tile_offset, tiles_to_load);
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
 }
 
 void GBC_Graphics_load_from_buffer_into_vram(GBC_Graphics *self, uint8_t *tile_buffer, 
                                                 uint16_t tiles_to_load, uint16_t vram_tile_offset, uint8_t vram_bank_number) {
     uint8_t *vram_offset = self->vram + GBC_VRAM_BANK_NUM_BYTES * vram_bank_number + vram_tile_offset * GBC_TILE_NUM_BYTES;
     memcpy(vram_offset, tile_buffer, tiles_to_load * GBC_TILE_NUM_BYTES);
+    update_tile_masks(self, (vram_bank_number << 8) + vram_tile_offset, tiles_to_load);
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
 }
 
 uint8_t *GBC_Graphics_get_vram_bank(GBC_Graphics *self, uint8_t vram_bank_number) {
@@ -155,11 +456,23 @@ static void set_palette(uint8_t *palette_bank, uint8_t palette_num, uint8_t num_
     }
 }
 
+/**
+ * Marks palettes as changed, both for the app and for the faded palettes built from them
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param palette_flags The dirty palette flags of the palettes that changed
+ */
+static void mark_palettes_dirty(GBC_Graphics *self, uint16_t palette_flags) {
+    self->dirty_palettes |= palette_flags;
+    self->fade_dirty_palettes |= palette_flags;
+}
+
 void GBC_Graphics_set_bg_palette(GBC_Graphics *self, uint8_t palette_num, uint8_t num_colors, ...) {
     va_list args;
     va_start(args, num_colors);
     set_palette(self->bg_palette_bank, palette_num, num_colors, args);
     va_end(args);
+    mark_palettes_dirty(self, GBC_DIRTY_BG_PALETTE_FLAG << palette_num);
 }
 
 void GBC_Graphics_set_sprite_palette(GBC_Graphics *self, uint8_t palette_num, uint8_t num_colors, ...) {
@@ -167,6 +480,7 @@ void GBC_Graphics_set_sprite_palette(GBC_Graphics *self, uint8_t palette_num, ui
     va_start(args, num_colors);
     set_palette(self->sprite_palette_bank, palette_num, num_colors, args);
     va_end(args);
+    mark_palettes_dirty(self, GBC_DIRTY_SPRITE_PALETTE_FLAG << palette_num);
 }
 
 /**
@@ -182,18 +496,22 @@ static void set_palette_array(uint8_t *palette_bank, uint8_t palette_num, uint8_
 
 void GBC_Graphics_set_bg_palette_array(GBC_Graphics *self, uint8_t palette_num, uint8_t *palette_array) {
     set_palette_array(self->bg_palette_bank, palette_num, palette_array);
+    mark_palettes_dirty(self, GBC_DIRTY_BG_PALETTE_FLAG << palette_num);
 }
 
 void GBC_Graphics_set_sprite_palette_array(GBC_Graphics *self, uint8_t palette_num, uint8_t *palette_array) {
     set_palette_array(self->sprite_palette_bank, palette_num, palette_array);
+    mark_palettes_dirty(self, GBC_DIRTY_SPRITE_PALETTE_FLAG << palette_num);
 }
 
 void GBC_Graphics_set_bg_palette_color(GBC_Graphics *self, uint8_t palette_num, uint8_t color_num, uint8_t c) {
     self->bg_palette_bank[palette_num*GBC_PALETTE_NUM_BYTES+color_num] = c;
+    mark_palettes_dirty(self, GBC_DIRTY_BG_PALETTE_FLAG << palette_num);
 }
 
 void GBC_Graphics_set_sprite_palette_color(GBC_Graphics *self, uint8_t palette_num, uint8_t color_num, uint8_t c) {
     self->sprite_palette_bank[palette_num*GBC_PALETTE_NUM_BYTES+color_num] = c;
+    mark_palettes_dirty(self, GBC_DIRTY_SPRITE_PALETTE_FLAG << palette_num);
 }
 
 static void copy_palette_array(uint8_t *palette_bank, uint8_t palette_num, uint8_t *target_array) {
@@ -220,6 +538,112 @@ void GBC_Graphics_copy_all_sprite_palettes(GBC_Graphics *self, uint8_t *target_a
     copy_palette_bank(self->sprite_palette_bank, target_array);
 }
 
+/**
+ * Sets the range and timing of a palette animation, and starts it if the range isn't empty
+ * 
+ * @param animation A pointer to the palette animation
+ * @param is_sprite_palette Should the sprite palettes be animated, instead of the background palettes?
+ * @param palette_num The palette of the first color, from 0 to 7
+ * @param color_num The first color, from 0 to 15
+ * @param num_colors The number of colors, which is cut short at the end of the palette bank
+ * @param period The number of frames between steps
+ */
+static void start_palette_animation(GBC_Palette_Animation *animation, bool is_sprite_palette, 
+                                    uint8_t palette_num, uint8_t color_num, uint8_t num_colors, uint8_t period) {
+    animation->start = palette_num * GBC_PALETTE_NUM_BYTES + color_num;
+    animation->num_colors = GBC_MIN(num_colors, GBC_PALETTE_BANK_NUM_BYTES - animation->start);
+    animation->flags = (GBC_PALETTE_ANIMATION_ENABLE_FLAG * (animation->num_colors != 0)) | (GBC_PALETTE_ANIMATION_SPRITE_FLAG * is_sprite_palette);
+    animation->period = GBC_MAX(period, 1);
+    animation->timer = animation->period;
+    animation->keyframe = 0;
+}
+
+/**
+ * Marks the palettes covered by a palette animation as dirty
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param animation A pointer to the palette animation
+ */
+static void mark_palette_animation_dirty(GBC_Graphics *self, GBC_Palette_Animation *animation) {
+    uint16_t dirty_flag = (animation->flags & GBC_PALETTE_ANIMATION_SPRITE_FLAG) ? GBC_DIRTY_SPRITE_PALETTE_FLAG : GBC_DIRTY_BG_PALETTE_FLAG;
+    uint8_t last_palette = (animation->start + animation->num_colors - 1) >> 4; // (start + num_colors - 1) / GBC_PALETTE_NUM_BYTES
+    for (uint8_t palette_num = animation->start >> 4; palette_num <= last_palette; palette_num++) {
+        mark_palettes_dirty(self, dirty_flag << palette_num);
+    }
+}
+
+/**
+ * Copies a palette animation's current keyframe into its colors
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param animation A pointer to the palette animation
+ */
+static void copy_palette_animation_keyframe(GBC_Graphics *self, GBC_Palette_Animation *animation) {
+    uint8_t *palette_bank = (animation->flags & GBC_PALETTE_ANIMATION_SPRITE_FLAG) ? self->sprite_palette_bank : self->bg_palette_bank;
+    memcpy(&palette_bank[animation->start], &animation->keyframes[animation->keyframe * animation->num_colors], animation->num_colors);
+}
+
+void GBC_Graphics_palette_animation_set_rotation(GBC_Graphics *self, uint8_t animation_num, bool is_sprite_palette, 
+                                                 uint8_t palette_num, uint8_t color_num, uint8_t num_colors, uint8_t period) {
+    GBC_Palette_Animation *animation = &self->palette_animations[animation_num];
+    start_palette_animation(animation, is_sprite_palette, palette_num, color_num, num_colors, period);
+    animation->keyframes = NULL;
+    animation->num_keyframes = 0;
+}
+
+void GBC_Graphics_palette_animation_set_keyframes(GBC_Graphics *self, uint8_t animation_num, bool is_sprite_palette, 
+                                                  uint8_t palette_num, uint8_t color_num, uint8_t num_colors, 
+                                                  uint8_t *keyframes, uint8_t num_keyframes, uint8_t period) {
+    GBC_Palette_Animation *animation = &self->palette_animations[animation_num];
+    start_palette_animation(animation, is_sprite_palette, palette_num, color_num, num_colors, period);
+    animation->keyframes = keyframes;
+    animation->num_keyframes = num_keyframes;
+    if (num_keyframes == 0) {
+        animation->flags &= ~GBC_PALETTE_ANIMATION_ENABLE_FLAG;
+    }
+    if (animation->flags & GBC_PALETTE_ANIMATION_ENABLE_FLAG) {
+        copy_palette_animation_keyframe(self, animation);
+        mark_palette_animation_dirty(self, animation);
+    }
+}
+
+void GBC_Graphics_palette_animation_stop(GBC_Graphics *self, uint8_t animation_num) {
+    self->palette_animations[animation_num].flags &= ~GBC_PALETTE_ANIMATION_ENABLE_FLAG;
+}
+
+/**
+ * Steps the running palette animations by one frame, changing the colors of any that are due
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ */
+static void step_palette_animations(GBC_Graphics *self) {
+    GBC_Palette_Animation *animation;
+    uint8_t *palette_bank;
+    uint8_t first_color;
+    for (uint8_t animation_num = 0; animation_num < GBC_NUM_PALETTE_ANIMATIONS; animation_num++) {
+        animation = &self->palette_animations[animation_num];
+        if ((animation->flags & GBC_PALETTE_ANIMATION_ENABLE_FLAG) == 0) continue;
+        if (--animation->timer != 0) continue;
+        animation->timer = animation->period;
+
+        if (animation->keyframes == NULL) {
+            // Rotate the colors towards the start, wrapping the first around to the end
+            palette_bank = (animation->flags & GBC_PALETTE_ANIMATION_SPRITE_FLAG) ? self->sprite_palette_bank : self->bg_palette_bank;
+            first_color = palette_bank[animation->start];
+            memmove(&palette_bank[animation->start], &palette_bank[animation->start + 1], animation->num_colors - 1);
+            palette_bank[animation->start + animation->num_colors - 1] = first_color;
+        } else {
+            animation->keyframe = (animation->keyframe + 1) % animation->num_keyframes;
+            copy_palette_animation_keyframe(self, animation);
+        }
+        mark_palette_animation_dirty(self, animation);
+    }
+}
+
+uint16_t GBC_Graphics_get_dirty_palettes(GBC_Graphics *self) {
+    return self->dirty_palettes;
+}
+
 /**
  * Sets the bits outlined by mask to new_value
  * 
@@ -244,80 +668,547 @@ static void modify_word(uint16_t *word, uint16_t mask, uint16_t new_value, uint1
     *word = (*word & ~mask) | new_value * word_start;
 }
 
+/**
+ * Marks background caches out of date, including any being rendered into this frame
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_flags The cache flags of the backgrounds that changed
+ */
+static void invalidate_bg_caches(GBC_Graphics *self, uint8_t bg_flags) {
+    self->bg_cache_valid &= ~bg_flags;
+    self->bg_cache_filling &= ~bg_flags;
+}
 
 /**
- * Renders the backgrounds and sprites called from an update proc
+ * Allocates a cached background's buffer at the current screen size, or frees it if the background isn't cached
  * 
  * @param self A pointer to the target GBC Graphics object
- * @param layer A pointer to the layer to modify
- * @param ctx The graphics context for drawing
+ * @param bg_layer The number of the background layer
  */
-static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
-    if (!(self->lcdc & GBC_LCDC_ENABLE_FLAG)) return;
-    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+static void allocate_bg_cache(GBC_Graphics *self, uint8_t bg_layer) {
+    free(self->bg_caches[bg_layer]);
+    self->bg_caches[bg_layer] = NULL;
+    if (self->bg_cached & (GBC_BG_CACHE_FLAG << bg_layer)) {
+        self->bg_caches[bg_layer] = (uint8_t*)malloc(self->screen_width * self->screen_height);
+    }
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+/**
+ * Drops sprites from a line's sprite list until it fits within the line limit
+ * Sprites are kept in OAM order starting at the rotation, wrapping around to the start of the list,
+ * and the kept sprites stay in their original order so they still layer the same way
+ * 
+ * @param sprite_list The ids of the sprites on the line, in OAM order
+ * @param num_sprites The number of sprites in the list
+ * @param limit The max number of sprites to keep
+ * @param rotation How far into the list to start keeping sprites
+ * 
+ * @return The number of sprites left in the list
+ */
+static uint16_t limit_sprites_on_line(uint16_t *sprite_list, uint16_t num_sprites, uint8_t limit, uint8_t rotation) {
+    uint16_t start = rotation % num_sprites;
+    uint16_t num_kept = 0;
+    uint16_t rank;
+    for (uint16_t i = 0; i < num_sprites; i++) {
+        rank = i >= start ? i - start : i + num_sprites - start; // Position of the sprite counting from start
+        sprite_list[num_kept] = sprite_list[i];
+        num_kept += rank < limit;
+    }
+    return num_kept;
+}
+
+/**
+ * Fades one color towards the fade color
+ * 
+ * @param color The color to fade
+ * @param fade_color The color to fade towards
+ * @param amount The fade amount, from 0 to GBC_FADE_MAX
+ * 
+ * @return The faded color
+ */
+static uint8_t fade_color(uint8_t color, uint8_t fade_color, uint8_t amount) {
+#if defined(PBL_COLOR)
+    return GBC_MAKE_COLOR(
+        GBC_FADE_CHANNEL(GBC_GET_RED(color), GBC_GET_RED(fade_color), amount),
+        GBC_FADE_CHANNEL(GBC_GET_GREEN(color), GBC_GET_GREEN(fade_color), amount),
+        GBC_FADE_CHANNEL(GBC_GET_BLUE(color), GBC_GET_BLUE(fade_color), amount)
+    );
+#else
+    return GBC_FADE_CHANNEL(color, fade_color, amount);
+#endif
+}
+
+/**
+ * Picks the palette banks to render with, rebuilding the faded palettes that are out of date if they're needed
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_palettes A pointer to where the background palette bank to render with will be stored
+ * @param sprite_palettes A pointer to where the sprite palette bank to render with will be stored
+ */
+static void update_faded_palettes(GBC_Graphics *self, uint8_t **bg_palettes, uint8_t **sprite_palettes) {
+    uint16_t palette_flags = self->fade_dirty_palettes;
+    self->fade_dirty_palettes = 0x0000;
+    *bg_palettes = self->render_bg_palette_bank;
+    *sprite_palettes = self->render_sprite_palette_bank;
+    if (self->fade_amount == 0) return;
+    uint8_t amount = GBC_MIN(self->fade_amount, GBC_FADE_MAX);
+    for (uint8_t palette_num = 0; palette_num < GBC_PALETTE_NUM_PALETTES; palette_num++) {
+        uint8_t start = palette_num << 4; // palette_num * GBC_PALETTE_NUM_BYTES
+        if ((self->fade_targets & GBC_FADE_BG_FLAG) && (palette_flags & (GBC_DIRTY_BG_PALETTE_FLAG << palette_num))) {
+            for (uint8_t i = start; i < start + GBC_PALETTE_NUM_BYTES; i++) {
+                self->bg_faded_palette_bank[i] = fade_color(self->render_bg_palette_bank[i], self->fade_color, amount);
+            }
+        }
+        if ((self->fade_targets & GBC_FADE_SPRITE_FLAG) && (palette_flags & (GBC_DIRTY_SPRITE_PALETTE_FLAG << palette_num))) {
+            for (uint8_t i = start; i < start + GBC_PALETTE_NUM_BYTES; i++) {
+                self->sprite_faded_palette_bank[i] = fade_color(self->render_sprite_palette_bank[i], self->fade_color, amount);
+            }
+        }
+    }
+    if (self->fade_targets & GBC_FADE_BG_FLAG) {
+        *bg_palettes = self->bg_faded_palette_bank;
+    }
+    if (self->fade_targets & GBC_FADE_SPRITE_FLAG) {
+        *sprite_palettes = self->sprite_faded_palette_bank;
+    }
+}
+
+/**
+ * Converts a direct color pixel to the color drawn on this platform
+ * 
+ * @param pixel The direct color pixel, an 8 bit GColor
+ * 
+ * @return The GColor on color Pebbles, or the green channel as the GBC color on black and white Pebbles
+ */
+static inline uint8_t direct_pixel_color(uint8_t pixel) {
+#if defined(PBL_COLOR)
+    return pixel;
+#else
+    return GBC_GET_GREEN(pixel);
+#endif
+}
+
+/**
+ * Copies a line of a direct color background out of its image, wrapping around the map like tilemaps do
+ * The parts of the line off the image are filled with transparent pixels
+ * 
+ * @param line Where to copy the line to
+ * @param image The direct image to copy from
+ * @param map_x The x position on the map of the first pixel
+ * @param map_y The y position on the map of the line
+ * @param map_width The width of the map in pixels
+ * @param length The number of pixels to copy
+ */
+static void copy_direct_line(uint8_t *line, GBC_Direct_Image *image, uint16_t map_x, uint16_t map_y, uint16_t map_width, uint8_t length) {
+    uint16_t run, on_image;
+    while (length > 0) {
+        // Copy up to where the map wraps, taking whatever part of that lands on the image
+        run = GBC_MIN(length, map_width - map_x);
+        on_image = (map_y < image->height && map_x < image->width) ? GBC_MIN(run, image->width - map_x) : 0;
+        if (on_image > 0) {
+            // Only point into the image where part of the line lands on it, since it may not be set yet
+            uint8_t *row = image->pixels + map_y * image->width;
+            memcpy(line, row + map_x, on_image);
+        }
+        memset(line + on_image, 0x00, run - on_image);
+        line += run;
+        length -= run;
+        map_x = (map_x + run) & (map_width - 1);
+    }
+}
+
+/**
+ * Finds the number of a tile within a background's map, wrapping around the map
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer
+ * @param x The x position of the tile on the map
+ * @param y The y position of the tile on the map
+ * 
+ * @return The offset of the tile from the start of the background's map, in tiles
+ */
+static inline uint16_t get_map_offset(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+    uint8_t width_shift = (self->bg_map_sizes[bg_layer] & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT;
+    uint8_t height_shift = self->bg_map_sizes[bg_layer] & GBC_MAP_SIZE_HEIGHT_MASK;
+    return (x & ((1 << width_shift) - 1)) + ((y & ((1 << height_shift) - 1)) << width_shift); // x % width + (y % height) * width
+}
+
+/**
+ * Finds the attributes of a tile on a background's map
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer
+ * @param x The x position of the tile on the map
+ * @param y The y position of the tile on the map
+ * 
+ * @return A pointer to the tile's attributes in the attrmaps
+ */
+static inline uint8_t *get_map_attr(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+    return &self->bg_attrmaps[self->bg_attrmap_offsets[bg_layer] + get_map_offset(self, bg_layer, x, y)];
+}
+
+/**
+ * Gets the number of a tile on a background's map, as it's stored in the tilemap
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer
+ * @param x The x position of the tile on the map
+ * @param y The y position of the tile on the map
+ * 
+ * @return The tile number, 16 bits for wide maps and 8 bits otherwise
+ */
+static inline uint16_t get_map_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+    uint8_t *tilemap = self->bg_tilemaps + self->bg_tilemap_offsets[bg_layer];
+    if (self->bg_map_sizes[bg_layer] & GBC_MAP_WIDE_TILES_FLAG) {
+        return ((uint16_t*)tilemap)[get_map_offset(self, bg_layer, x, y)];
+    }
+    return tilemap[get_map_offset(self, bg_layer, x, y)];
+}
+
+/**
+ * Sets the number of a tile on a background's map, as it's stored in the tilemap
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer
+ * @param x The x position of the tile on the map
+ * @param y The y position of the tile on the map
+ * @param tile_number The tile number, only the lower 8 bits are kept on maps that aren't wide
+ */
+static inline void set_map_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint16_t tile_number) {
+    uint8_t *tilemap = self->bg_tilemaps + self->bg_tilemap_offsets[bg_layer];
+    if (self->bg_map_sizes[bg_layer] & GBC_MAP_WIDE_TILES_FLAG) {
+        ((uint16_t*)tilemap)[get_map_offset(self, bg_layer, x, y)] = tile_number;
+    } else {
+        tilemap[get_map_offset(self, bg_layer, x, y)] = tile_number;
+    }
+}
+
+/**
+ * Finds the pixel of a background at a position on its map
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_num The number of the background layer
+ * @param u The x position on the map, in 8.8 fixed point
+ * @param v The y position on the map, in 8.8 fixed point
+ * @param palette_bank A pointer to the palette bank to take the color from
+ * @param color A pointer to where the pixel's color will be stored
+ * 
+ * @return The pixel's offset in the palette bank (palette number * GBC_PALETTE_NUM_BYTES + pixel number),
+ *         GBC_DIRECT_COLOR_PIXEL for direct color pixels, or GBC_BG_NO_PIXEL if the background isn't drawn there
+ */
+static inline uint8_t get_bg_pixel(GBC_Graphics *self, uint8_t bg_num, int32_t u, int32_t v, uint8_t *palette_bank, uint8_t *color) {
+    uint8_t width_shift = ((self->bg_map_sizes[bg_num] & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT) + 3; // log2 of the map width in pixels
+    uint8_t height_shift = (self->bg_map_sizes[bg_num] & GBC_MAP_SIZE_HEIGHT_MASK) + 3; // log2 of the map height in pixels
+    uint16_t map_x = (u >> 8) & ((1 << width_shift) - 1); // Wrap around the map
+    uint16_t map_y = (v >> 8) & ((1 << height_shift) - 1);
+    bool on_map = ((uint32_t)u >> (width_shift + 8)) == 0 && ((uint32_t)v >> (height_shift + 8)) == 0; // Both within the map << 8
+    if (!on_map && (self->bg_affine & (GBC_BG_AFFINE_CLIP_FLAG << bg_num))) return GBC_BG_NO_PIXEL;
+
+    if (self->bg_direct_color & (GBC_BG_DIRECT_COLOR_FLAG << bg_num)) {
+        // Direct color backgrounds read their image instead, and are clear off the image
+        GBC_Direct_Image *image = &self->bg_direct_images[bg_num];
+        if (map_x >= image->width || map_y >= image->height) return GBC_BG_NO_PIXEL;
+        uint8_t direct_pixel = image->pixels[map_y * image->width + map_x];
+        if ((direct_pixel & GBC_DIRECT_COLOR_ALPHA_MASK) == 0) return GBC_BG_NO_PIXEL;
+        *color = direct_pixel_color(direct_pixel);
+        return GBC_DIRECT_COLOR_PIXEL;
+    }
+
+    uint8_t *tilemap = self->bg_tilemaps + self->bg_tilemap_offsets[bg_num];
+    uint8_t *attrmap = self->bg_attrmaps + self->bg_attrmap_offsets[bg_num];
+
+    // Find the tile that the pixel is on
+    uint8_t map_tile_x = map_x >> 3; // map_x / GBC_TILE_WIDTH
+    uint8_t map_tile_y = map_y >> 3; // map_y / GBC_TILE_HEIGHT
+
+    // Get the tile and attrs from the map
+    uint16_t map_offset = map_tile_x + (map_tile_y << (width_shift - 3)); // map_tile_x + map_tile_y * map width in tiles
+    uint8_t tile_attr = attrmap[map_offset];
+
+    if (tile_attr & GBC_ATTR_HIDE_FLAG) return GBC_BG_NO_PIXEL;
+
+    // Get the tile number across all of vram, wide maps hold all of it and other maps keep the vram bank in the attrs
+    uint16_t tile_num;
+    if (self->bg_map_sizes[bg_num] & GBC_MAP_WIDE_TILES_FLAG) {
+        tile_num = ((uint16_t*)tilemap)[map_offset] & GBC_WIDE_TILE_MASK;
+    } else {
+        tile_num = tilemap[map_offset] | ((tile_attr & GBC_ATTR_VRAM_BANK_MASK) << 5); // tile_num + vram_bank_number * 256
+    }
+    
+    // Get the tile from vram
+    uint16_t offset;
+    uint8_t *tile = self->vram + (tile_num << 5); // self->vram + tile_num * GBC_TILE_NUM_BYTES
+
+    // Next, we extract and return the 4bpp pixel from the tile
+    uint8_t pixel_x = map_x & 7; // map_x % GBC_TILE_WIDTH
+    uint8_t pixel_y = map_y & 7; // map_x % GBC_TILE_HEIGHT
+
+    // Apply flip flags if necessary
+    uint8_t flip_x = (tile_attr & GBC_ATTR_FLIP_FLAG_X) != 0; // Flip becomes 1
+    pixel_x = pixel_x + (BOOL_MASK[flip_x] & (GBC_TILE_WIDTH - (pixel_x << 1) - 1)); // pixel_x = flip_x ? tile_width - pixel_x - 1 : pixel_x
+    uint8_t flip_y = (tile_attr & GBC_ATTR_FLIP_FLAG_Y) != 0; // Flip becomes 1
+    pixel_y = pixel_y + (BOOL_MASK[flip_y] & (GBC_TILE_HEIGHT - (pixel_y << 1) - 1)); // pixel_y = flip_y ? tile_width - pixel_y - 1 : pixel_y
+
+    // To get the pixel, we first need to get the corresponding byte the pixel is in
+    // There are 4 bytes per row (y * 4), and 2 pixels per byte (x / 2)
+    offset = (pixel_y << 2) + (pixel_x >> 1); // pixel y * 4 + pixel_x / 2
+    uint8_t pixel_byte = tile[offset];
+
+    // Once we have the byte, we need to get the 4 bit pixel out of the byte
+    // This is achieved by shifting the byte (1 - x % 2) * (4 bits per pixel)
+    uint8_t shift = (1 ^ (pixel_x & 1)) << 2; // (1 - pixel_x % 2) * 4
+
+    // We shift the byte and get rid of any unwanted bits
+    uint8_t pixel = 0b1111 & (pixel_byte >> shift);
+
+    // Finally, we get the corresponding color from attribute palette
+    offset = ((tile_attr & GBC_ATTR_PALETTE_MASK) << 4) + pixel; // (tile_attr & GBC_ATTR_PALETTE_MASK) * GBC_PALETTE_NUM_BYTES + pixel
+    *color = palette_bank[offset];
+    return offset;
+}
+
+/**
+ * Renders the backgrounds and sprites into a bitmap, which is the framebuffer when called from the update proc
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param fb A pointer to the bitmap to draw into
+ * @param on_screen Whether this is the frame on screen, which latches the registers, runs the line callbacks,
+ *                  and reads and fills the background caches, rather than a copy drawn somewhere else
+ * 
+ * @return Whether the frame was drawn, which it isn't while the LCD is disabled
+ */
+static bool render_graphics(GBC_Graphics *self, GBitmap *fb, bool on_screen) {
+    if (on_screen) {
+        GBC_Graphics_shadow_latch(self); // The registers are only read from their render copies until the next frame
+    }
+    if (!(*self->render_lcdc & GBC_LCDC_ENABLE_FLAG)) return false;
+    GRect fb_bounds = gbitmap_get_bounds(fb);
+    GBitmapDataRowInfo info;
+    uint8_t min_x, max_x;
 
     // Predefine the variables we'll use in the loop
-    uint8_t map_x, map_y, map_tile_x, map_tile_y, tile_num, tile_attr;
-    uint8_t *tilemap, *attrmap;
     uint16_t offset;
     uint8_t *tile;
     uint8_t pixel_x, pixel_y, pixel_byte, pixel_color, pixel;
     uint8_t shift;
     uint8_t x;
-    uint8_t flip_x, flip_y;
     short bg_num;
     
     uint8_t tile_x, tile_y;
     uint8_t x_on_sprite, y_on_sprite;
-    uint8_t *sprite;
+    GBC_Sprite_Cache *sprite_cache = &self->render_sprite_cache;
     uint8_t sprite_w, sprite_h;
     uint8_t sprite_tile_offset;
     short sprite_x, sprite_y;
+    short sprite_box_w, sprite_box_h;
+    short sprite_center_x, sprite_center_y;
+    int16_t *affine_matrix;
+    GBC_Line_Step *sprite_step;
+    GBC_Line_Step *bg_step;
+    int16_t *bg_affine_params;
+    bool on_sprite;
     uint8_t sprite_mos_x, sprite_mos_y;
     short sprite_id;
 
-    uint8_t sprites_on_this_line[GBC_NUM_SPRITES];
-    uint8_t num_sprites_on_this_line;
-    uint8_t sprite_line_index;
+    uint8_t bg_mosaic_width[GBC_MAX_NUM_BACKGROUNDS];
+    uint8_t bg_mosaic_height, bg_mosaic_rows, bg_mosaic_offset;
+    uint16_t bg_map_width, bg_map_height; // The size of a direct color background's map in pixels
+    uint8_t bg_mosaic_count[GBC_MAX_NUM_BACKGROUNDS]; // Pixels left in the current block
+    uint8_t bg_mosaic_pixel[GBC_MAX_NUM_BACKGROUNDS]; // The palette bank offset of the pixel shown by the current block
+    uint8_t bg_mosaic_color[GBC_MAX_NUM_BACKGROUNDS]; // The color shown by the current block
+    uint8_t *bg_direct_line[GBC_MAX_NUM_BACKGROUNDS]; // The line copied out of the direct image, NULL if the background doesn't copy lines
+    uint8_t *bg_cache_line[GBC_MAX_NUM_BACKGROUNDS]; // The line of an up to date cache to read from, NULL if there isn't one
+    uint8_t *bg_cache_fill_line[GBC_MAX_NUM_BACKGROUNDS]; // The line of a cache to render into, NULL if there isn't one
+
+    uint8_t *bg_palettes, *sprite_palettes;
+    uint32_t fade_registers;
+    uint32_t faded_registers = 0xFFFFFFFF; // The fade registers the palettes were last faded with, none yet
+
+    uint16_t *sprites_on_this_line = self->line_sprites;
+    uint16_t num_sprites_on_this_line;
+    uint16_t sprite_line_index;
     bool on_this_line;
+    uint32_t *sprite_bin;
+    uint32_t sprite_bin_bits;
+    uint16_t sprite_bin_word;
 
     uint8_t new_pixel_color;
 
     uint8_t background_start = self->num_backgrounds - 1;
     uint8_t sprite_layer_z;
+#if GBC_CONFIG_ALPHA
     uint8_t alpha_mode;
     bool alpha_enabled;
+#endif
     uint8_t alpha_mode_result;
 
+#if defined(PBL_BW)
+    uint8_t line_dither_masks[GBC_NUM_DITHER_MODES << 2]; // This line's row of each dither pattern, 4 colors per mode
+    uint8_t *bg_dither_masks[GBC_MAX_NUM_BACKGROUNDS];
+    uint8_t *sprite_dither_masks, *pixel_dither_masks;
+    uint8_t dither_index;
+#endif
+
+    // Cached backgrounds that are out of date get rendered into their caches this frame
+    self->bg_cache_filling = self->bg_cached & ~self->bg_cache_valid & ~self->bg_direct_color & BOOL_MASK[on_screen];
+
+    // Affine backgrounds start the frame at their reference points
+    memcpy(self->bg_affine_line_x, self->bg_affine_ref_x, self->num_backgrounds * sizeof(int32_t));
+    memcpy(self->bg_affine_line_y, self->bg_affine_ref_y, self->num_backgrounds * sizeof(int32_t));
+
     // Start by going through all of the rows
     self->stat &= ~GBC_STAT_VBLANK_FLAG; // No longer in VBlank while we draw
     for (self->line_y = 0; self->line_y < self->screen_height; self->line_y++) {
         // Check if the current line matches the line compare value, and then do the callback
         self->stat &= ~GBC_STAT_LINE_COMP_FLAG;
         self->stat |= GBC_STAT_LINE_COMP_FLAG * (self->line_y == self->line_y_compare);
-        if ((self->stat & (GBC_STAT_LINE_COMP_INT_FLAG | GBC_STAT_LINE_COMP_FLAG)) == (GBC_STAT_LINE_COMP_INT_FLAG | GBC_STAT_LINE_COMP_FLAG)) {
+        if (on_screen && (self->stat & (GBC_STAT_LINE_COMP_INT_FLAG | GBC_STAT_LINE_COMP_FLAG)) == (GBC_STAT_LINE_COMP_INT_FLAG | GBC_STAT_LINE_COMP_FLAG)) {
             self->line_compare_interrupt_callback(self);
         }
 
-        GBitmapDataRowInfo info = gbitmap_get_data_row_info(fb, self->line_y + self->screen_y_origin);
-        uint8_t min_x = GBC_MAX(info.min_x, self->screen_x_origin);
-        uint8_t max_x = GBC_MIN(info.max_x+1, self->screen_x_origin + self->screen_width);
+        // Fade every palette if the fade registers have changed since they were last faded, or just the palettes changed since then
+        fade_registers = self->fade_targets | (self->fade_color << 8) | (self->fade_amount << 16);
+        if (fade_registers != faded_registers) {
+            self->fade_dirty_palettes = 0xFFFF;
+            faded_registers = fade_registers;
+        }
+        if (self->fade_dirty_palettes) {
+            update_faded_palettes(self, &bg_palettes, &sprite_palettes);
+        }
+
+    #if defined(PBL_BW)
+        // Pick out this line's row of each dither pattern, and the patterns each layer uses
+        for (dither_index = 0; dither_index < (GBC_NUM_DITHER_MODES << 2); dither_index++) {
+            line_dither_masks[dither_index] = DITHER_ROW_MASKS[dither_index][self->line_y & 3];
+        }
+        for (bg_num = 0; bg_num < self->num_backgrounds; bg_num++) {
+            bg_dither_masks[bg_num] = &line_dither_masks[GBC_Graphics_dither_get_bg_mode(self, bg_num) << 2];
+        }
+        sprite_dither_masks = &line_dither_masks[GBC_Graphics_dither_get_sprite_mode(self) << 2];
+    #endif
+
+        // Lines past the bottom of the bitmap still run, so the callbacks and affine steps match, but draw nothing
+        min_x = max_x = 0;
+        if (self->line_y + self->screen_y_origin < fb_bounds.origin.y + fb_bounds.size.h) {
+            info = gbitmap_get_data_row_info(fb, self->line_y + self->screen_y_origin);
+            min_x = GBC_MAX(info.min_x, self->screen_x_origin);
+            max_x = GBC_MIN(info.max_x+1, self->screen_x_origin + self->screen_width);
+        }
 
-        sprite_layer_z = (self->lcdc & GBC_LCDC_SPRITE_LAYER_Z_MASK) >> GBC_LCDC_SPRITE_LAYER_Z_SHIFT;
+        sprite_layer_z = (*self->render_lcdc & GBC_LCDC_SPRITE_LAYER_Z_MASK) >> GBC_LCDC_SPRITE_LAYER_Z_SHIFT;
         sprite_layer_z = GBC_MIN(sprite_layer_z, background_start);
         num_sprites_on_this_line = 0;
-        for (sprite_id = 0; sprite_id < (GBC_NUM_SPRITES & BOOL_MASK[(self->lcdc & GBC_LCDC_SPRITE_ENABLE_FLAG) != 0]); sprite_id++) {
-            sprite = &self->oam[sprite_id * GBC_SPRITE_NUM_BYTES];
-            sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
-            sprite_y = sprite[GBC_OAM_Y_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_Y;
-                sprite_w = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT)) << 3; // sprite_width * tile_width
-                sprite_h = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT)) << 3; // sprite_height * tile_height
-            on_this_line = self->line_y >= sprite_y && self->line_y < (sprite_y + sprite_h)
-                            && (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_HIDE_FLAG) == 0 
-                            && sprite_x <= max_x && (sprite_x + sprite_w) >= min_x;
-                            
-            sprites_on_this_line[num_sprites_on_this_line] = sprite_id & BOOL_MASK[on_this_line];
-            num_sprites_on_this_line += on_this_line;
+        sprite_bin = self->render_sprite_bins + (self->line_y >> GBC_SPRITE_BIN_SHIFT) * self->sprite_bin_words;
+        for (sprite_bin_word = 0; sprite_bin_word < (self->sprite_bin_words & BOOL_MASK[(*self->render_lcdc & GBC_LCDC_SPRITE_ENABLE_FLAG) != 0]); sprite_bin_word++) {
+            // Only check the sprites in this line's bin, lowest bit (and so OAM order) first
+            for (sprite_bin_bits = sprite_bin[sprite_bin_word]; sprite_bin_bits != 0; sprite_bin_bits &= sprite_bin_bits - 1) {
+                sprite_id = (sprite_bin_word << 5) + __builtin_ctz(sprite_bin_bits); // sprite_bin_word * 32 + lowest set bit
+                sprite_x = sprite_cache->x[sprite_id] + self->screen_x_origin;
+                sprite_y = sprite_cache->y[sprite_id];
+                sprite_box_w = sprite_cache->width[sprite_id] << sprite_cache->size_shift[sprite_id];
+                sprite_box_h = sprite_cache->height[sprite_id] << sprite_cache->size_shift[sprite_id];
+                // Sprites have to overlap the visible span of the line (the circle on round Pebbles), so the hidden ones don't use up the line limit
+                on_this_line = self->line_y >= sprite_y && self->line_y < (sprite_y + sprite_box_h)
+                                && (sprite_cache->attrs[sprite_id] & GBC_ATTR_HIDE_FLAG) == 0 
+                                && sprite_x < max_x && (sprite_x + sprite_box_w) > min_x;
+                                
+                sprites_on_this_line[num_sprites_on_this_line] = sprite_id & BOOL_MASK[on_this_line];
+                num_sprites_on_this_line += on_this_line;
+            }
+        }
+
+        // Keep the sprite count within the line limit
+        if (self->sprite_line_limit != 0 && num_sprites_on_this_line > self->sprite_line_limit) {
+            num_sprites_on_this_line = limit_sprites_on_line(sprites_on_this_line, num_sprites_on_this_line, self->sprite_line_limit, self->sprite_flicker_offset);
+        }
+
+        // Find where each sprite's first pixel on this line lands on the sprite, and how far it moves per pixel
+        for (sprite_line_index = 0; sprite_line_index < num_sprites_on_this_line; sprite_line_index++) {
+            sprite_id = sprites_on_this_line[sprite_line_index];
+            sprite_step = &self->line_sprite_steps[sprite_line_index];
+            sprite_x = sprite_cache->x[sprite_id] + self->screen_x_origin;
+            sprite_y = sprite_cache->y[sprite_id];
+            sprite_w = sprite_cache->width[sprite_id];
+            sprite_h = sprite_cache->height[sprite_id];
+            if (sprite_cache->affine_matrix[sprite_id] == GBC_SPRITE_NOT_AFFINE) {
+                // Regular sprites move one pixel on the sprite per pixel on the screen, backwards if flipped
+                sprite_step->u = (min_x - sprite_x) * GBC_AFFINE_ONE;
+                sprite_step->v = (self->line_y - sprite_y) * GBC_AFFINE_ONE;
+                sprite_step->du = GBC_AFFINE_ONE;
+                sprite_step->dv = 0;
+                if (sprite_cache->attrs[sprite_id] & GBC_ATTR_FLIP_FLAG_X) {
+                    sprite_step->u = ((sprite_w - 1) << 8) - sprite_step->u;
+                    sprite_step->du = -GBC_AFFINE_ONE;
+                }
+                if (sprite_cache->attrs[sprite_id] & GBC_ATTR_FLIP_FLAG_Y) {
+                    sprite_step->v = ((sprite_h - 1) << 8) - sprite_step->v;
+                }
+            } else {
+                // Affine sprites are rotated and scaled around the center of their bounding box
+                affine_matrix = &self->render_sprite_affine_matrices[sprite_cache->affine_matrix[sprite_id] * GBC_AFFINE_MATRIX_NUM_VALUES];
+                sprite_center_x = sprite_x + ((sprite_w << sprite_cache->size_shift[sprite_id]) >> 1);
+                sprite_center_y = sprite_y + ((sprite_h << sprite_cache->size_shift[sprite_id]) >> 1);
+                sprite_step->u = (sprite_w << 7) + affine_matrix[0] * (min_x - sprite_center_x) + affine_matrix[1] * (self->line_y - sprite_center_y); // sprite_w / 2 + pa * dx + pb * dy
+                sprite_step->v = (sprite_h << 7) + affine_matrix[2] * (min_x - sprite_center_x) + affine_matrix[3] * (self->line_y - sprite_center_y); // sprite_h / 2 + pc * dx + pd * dy
+                sprite_step->du = affine_matrix[0];
+                sprite_step->dv = affine_matrix[2];
+            }
+        }
+
+        // Find where each background's first pixel on this line lands on its map, and how far it moves per pixel
+        for (bg_num = 0; bg_num < self->num_backgrounds; bg_num++) {
+            bg_step = &self->line_bg_steps[bg_num];
+        #if GBC_CONFIG_MOSAIC
+            bg_mosaic_width[bg_num] = ((self->bg_mosaic[bg_num] & GBC_BG_MOSAIC_WIDTH_MASK) >> GBC_BG_MOSAIC_WIDTH_SHIFT) + 1;
+            bg_mosaic_height = ((self->bg_mosaic[bg_num] & GBC_BG_MOSAIC_HEIGHT_MASK) >> GBC_BG_MOSAIC_HEIGHT_SHIFT) + 1;
+        #else
+            bg_mosaic_width[bg_num] = 1; // Mosaic is compiled out, so every block is one pixel
+            bg_mosaic_height = 1;
+        #endif
+            bg_mosaic_rows = self->line_y % bg_mosaic_height; // Lines since the top of the mosaic block, which every line of the block shows
+            if (self->bg_affine & (GBC_BG_AFFINE_ENABLE_FLAG << bg_num)) {
+                bg_affine_params = &self->bg_affine_params[bg_num * GBC_AFFINE_MATRIX_NUM_VALUES];
+                bg_step->u = self->bg_affine_line_x[bg_num] - bg_affine_params[1] * bg_mosaic_rows + bg_affine_params[0] * (min_x - self->screen_x_origin); // line_x - dmx * rows + dx * screen_x
+                bg_step->v = self->bg_affine_line_y[bg_num] - bg_affine_params[3] * bg_mosaic_rows + bg_affine_params[2] * (min_x - self->screen_x_origin); // line_y - dmy * rows + dy * screen_x
+                bg_step->du = bg_affine_params[0];
+                bg_step->dv = bg_affine_params[2];
+            } else {
+                // Scrolled backgrounds move one pixel on the map per pixel on the screen
+                bg_step->u = ((min_x - self->screen_x_origin) + self->render_bg_scroll_x[bg_num]) * GBC_AFFINE_ONE;
+                bg_step->v = (self->line_y - bg_mosaic_rows + self->render_bg_scroll_y[bg_num]) * GBC_AFFINE_ONE;
+                bg_step->du = GBC_AFFINE_ONE;
+                bg_step->dv = 0;
+            }
+
+            // The first block can start before the line does, so find its pixel from where it starts
+            bg_mosaic_offset = (min_x - self->screen_x_origin) % bg_mosaic_width[bg_num];
+            bg_mosaic_pixel[bg_num] = get_bg_pixel(self, bg_num, bg_step->u - bg_step->du * bg_mosaic_offset, bg_step->v - bg_step->dv * bg_mosaic_offset, bg_palettes, &bg_mosaic_color[bg_num]);
+            bg_mosaic_count[bg_num] = bg_mosaic_width[bg_num] - bg_mosaic_offset;
+
+            // Unscaled direct color backgrounds copy the whole line out of their image at once, or read it a pixel at a time without a line buffer
+            bg_direct_line[bg_num] = NULL;
+            if ((self->bg_direct_color & (GBC_BG_DIRECT_COLOR_FLAG << bg_num)) && self->line_direct_pixels != NULL && !(self->bg_affine & (GBC_BG_AFFINE_ENABLE_FLAG << bg_num)) && bg_mosaic_width[bg_num] == 1) {
+                bg_direct_line[bg_num] = self->line_direct_pixels + (bg_num << 8); // bg_num * 256
+                bg_map_width = 8 << ((self->bg_map_sizes[bg_num] & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT); // In pixels
+                bg_map_height = 8 << (self->bg_map_sizes[bg_num] & GBC_MAP_SIZE_HEIGHT_MASK);
+                copy_direct_line(bg_direct_line[bg_num], &self->bg_direct_images[bg_num], (bg_step->u >> 8) & (bg_map_width - 1), (bg_step->v >> 8) & (bg_map_height - 1), 
+                                 bg_map_width, max_x > min_x ? max_x - min_x : 0);
+            }
+
+            // Cached backgrounds read their cache while it's up to date, or render into it on the frame they're refreshed
+            bg_cache_line[bg_num] = NULL;
+            bg_cache_fill_line[bg_num] = NULL;
+            if (on_screen && self->bg_caches[bg_num] != NULL) {
+                if ((*self->render_lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) {
+                    self->bg_cache_filling &= ~(GBC_BG_CACHE_FLAG << bg_num); // This line won't be drawn, so the cache can't be finished this frame
+                }
+                if (self->bg_cache_valid & (GBC_BG_CACHE_FLAG << bg_num)) {
+                    bg_cache_line[bg_num] = self->bg_caches[bg_num] + self->line_y * self->screen_width;
+                } else if (self->bg_cache_filling & (GBC_BG_CACHE_FLAG << bg_num)) {
+                    bg_cache_fill_line[bg_num] = self->bg_caches[bg_num] + self->line_y * self->screen_width;
+                }
+            }
         }
 
         self->stat &= ~GBC_STAT_HBLANK_FLAG; // No longer in HBlank while we draw the line
@@ -325,64 +1216,54 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
         // Now for each pixel in the row:
         for(x = min_x; x < max_x; x++) {
             pixel_color = 0x00;
+        #if defined(PBL_BW)
+            pixel_dither_masks = line_dither_masks;
+        #endif
 
             // First draw the backgrounds below the sprite layer
             for (bg_num = 0; bg_num <= sprite_layer_z; bg_num++) {
-                if ((self->lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) continue;
+                if ((*self->render_lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) continue;
+
+                // Mosaic backgrounds only find a new pixel at the start of each block, then repeat it for the rest
+                bg_step = &self->line_bg_steps[bg_num];
+                if (bg_cache_line[bg_num] != NULL) {
+                    // Up to date cached backgrounds only need to read the pixel back
+                    bg_mosaic_pixel[bg_num] = bg_cache_line[bg_num][x - self->screen_x_origin];
+                    bg_mosaic_color[bg_num] = bg_palettes[bg_mosaic_pixel[bg_num] & (GBC_PALETTE_BANK_NUM_BYTES - 1)];
+                } else if (bg_direct_line[bg_num] != NULL) {
+                    // Copied direct color lines only need a lookup to see if the pixel is clear
+                    bg_mosaic_color[bg_num] = bg_direct_line[bg_num][x - min_x];
+                    bg_mosaic_pixel[bg_num] = (bg_mosaic_color[bg_num] & GBC_DIRECT_COLOR_ALPHA_MASK) ? GBC_DIRECT_COLOR_PIXEL : GBC_BG_NO_PIXEL;
+                    bg_mosaic_color[bg_num] = direct_pixel_color(bg_mosaic_color[bg_num]);
+                } else if (bg_mosaic_count[bg_num] == 0) {
+                    bg_mosaic_pixel[bg_num] = get_bg_pixel(self, bg_num, bg_step->u, bg_step->v, bg_palettes, &bg_mosaic_color[bg_num]);
+                    bg_mosaic_count[bg_num] = bg_mosaic_width[bg_num];
+                }
+                bg_mosaic_count[bg_num]--;
 
-                map_x = (x - self->screen_x_origin) + self->bg_scroll_x[bg_num];
-                map_y = self->line_y + self->bg_scroll_y[bg_num];
-                tile = self->vram + (bg_num << 10) + offset; // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES + offset
-                tilemap = self->bg_tilemaps + (bg_num << 10); // self->bg_tilemaps + bg_num * GBC_TILEMAP_NUM_BYTES
-                attrmap = self->bg_attrmaps + (bg_num << 10); // self->bg_attrmaps + bg_num * GBC_ATTRMAP_NUM_BYTES
+                // Step to the next pixel
+                bg_step->u += bg_step->du;
+                bg_step->v += bg_step->dv;
 
-                // Find the tile that the pixel is on
-                map_tile_x = map_x >> 3; // map_x / GBC_TILE_WIDTH
-                map_tile_y = map_y >> 3; // map_y / GBC_TILE_HEIGHT
+                if (bg_cache_fill_line[bg_num] != NULL) {
+                    bg_cache_fill_line[bg_num][x - self->screen_x_origin] = bg_mosaic_pixel[bg_num];
+                }
 
-                // Get the tile and attrs from the map
-                tile_num = tilemap[map_tile_x + (map_tile_y << 5)]; // map_tile_y * MAP_WIDTH ??? what ???
-                tile_attr = attrmap[map_tile_x + (map_tile_y << 5)];
+                pixel = bg_mosaic_pixel[bg_num];
+                if (pixel == GBC_BG_NO_PIXEL) continue;
+                pixel &= 0x0F; // Just the pixel number, without its palette's offset
+                new_pixel_color = bg_mosaic_color[bg_num];
 
-                if (tile_attr & GBC_ATTR_HIDE_FLAG) continue;
-                
-                // Get the tile from vram
-                offset = tile_num << 5; // tile_num * GBC_TILE_NUM_BYTES
-                tile = self->vram + ((((tile_attr & GBC_ATTR_VRAM_BANK_MASK) >> 3)) << 13) + offset; // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES + offset
-
-                // Next, we extract and return the 4bpp pixel from the tile
-                pixel_x = map_x & 7; // map_x % GBC_TILE_WIDTH
-                pixel_y = map_y & 7; // map_x % GBC_TILE_HEIGHT
-
-                // Apply flip flags if necessary
-                flip_x = (tile_attr & GBC_ATTR_FLIP_FLAG_X) != 0; // Flip becomes 1
-                pixel_x = pixel_x + (BOOL_MASK[flip_x] & (GBC_TILE_WIDTH - (pixel_x << 1) - 1)); // pixel_x = flip_x ? tile_width - pixel_x - 1 : pixel_x
-                flip_y = (tile_attr & GBC_ATTR_FLIP_FLAG_Y) != 0; // Flip becomes 1
-                pixel_y = pixel_y + (BOOL_MASK[flip_y] & (GBC_TILE_HEIGHT - (pixel_y << 1) - 1)); // pixel_y = flip_y ? tile_width - pixel_y - 1 : pixel_y
-
-                // To get the pixel, we first need to get the corresponding byte the pixel is in
-                // There are 4 bytes per row (y * 4), and 2 pixels per byte (x / 2)
-                offset = (pixel_y << 2) + (pixel_x >> 1); // pixel y * 4 + pixel_x / 2
-                pixel_byte = tile[offset];
-
-                // Once we have the byte, we need to get the 4 bit pixel out of the byte
-                // This is achieved by shifting the byte (1 - x % 2) * (4 bits per pixel)
-                shift = (1 ^ (pixel_x & 1)) << 2; // (1 - pixel_x % 2) * 4
-
-                // We shift the byte and get rid of any unwanted bits
-                pixel = 0b1111 & (pixel_byte >> shift);
-
-                // Finally, we get the corresponding color from attribute palette
-                new_pixel_color = self->bg_palette_bank[((tile_attr & GBC_ATTR_PALETTE_MASK) << 4) + pixel]; // (tile_attr & GBC_ATTR_PALETTE_MASK) * GBC_PALETTE_NUM_BYTES + pixel
-
-                // Check if we should do an alpha blend
-                alpha_enabled = (self->a_mode & (GBC_ALPHA_MODE_BG_ENABLED_FLAG << (bg_num << 2))) != 0;
-                alpha_mode = (((self->a_mode & (GBC_ALPHA_MODE_MASK << (bg_num << 2))) >> (bg_num << 2)) >> GBC_ALPHA_MODE_SHIFT) & BOOL_MASK[alpha_enabled];
+            #if GBC_CONFIG_ALPHA
+                // Check if we should do an alpha blend
+                alpha_enabled = (self->a_mode & (GBC_ALPHA_MODE_BG_ENABLED_FLAG << (bg_num << 2))) != 0;
+                alpha_mode = (((self->a_mode & (GBC_ALPHA_MODE_MASK << (bg_num << 2))) >> (bg_num << 2)) >> GBC_ALPHA_MODE_SHIFT) & BOOL_MASK[alpha_enabled];
+            #endif
                 
                 // Create the alpha blends
                 // Mode 0: Normal
                 alpha_mode_result = (pixel_color & BOOL_MASK[pixel == 0 && bg_num != 0]) + (new_pixel_color & BOOL_MASK[pixel != 0 || bg_num == 0]);
-            #if defined(PBL_COLOR)
+            #if GBC_CONFIG_ALPHA && defined(PBL_COLOR)
                 switch(alpha_mode) {
                     case 1:
                         // Mode 1: Add
@@ -433,7 +1314,7 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
                         );
                         break;
                 }
-            #else
+            #elif GBC_CONFIG_ALPHA
                 switch (alpha_mode) {
                     case 1:
                         // Mode 1: Add
@@ -464,37 +1345,41 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
 
                 // Now pick the appropriate alpha result
                 pixel_color = alpha_mode_result;
+            #if defined(PBL_BW)
+                // The pixel takes the dither of the top layer drawn on it
+                pixel_dither_masks = (pixel != 0 || bg_num == 0) ? bg_dither_masks[bg_num] : pixel_dither_masks;
+            #endif
             }
 
             // Draw the sprite layer, but only the sprites on this line
             for (sprite_line_index = 0; sprite_line_index < num_sprites_on_this_line; sprite_line_index++) {
-                // Get the sprite from OAM
+                // Get the sprite from the decoded sprite cache
                 sprite_id = sprites_on_this_line[sprite_line_index];
-                sprite = &self->oam[sprite_id*GBC_SPRITE_NUM_BYTES];
-
-                // Check if the pixel we're rendering is within the sprite
-                sprite_x = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
-                sprite_y = sprite[GBC_OAM_Y_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_Y;
-                sprite_w = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT)) << 3; // sprite_width * tile_width
-                sprite_h = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT)) << 3; // sprite_height * tile_height
-                sprite_mos_x = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_X_MASK) >> GBC_OAM_SPRITE_MOSAIC_X_SHIFT;
-                sprite_mos_y = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_Y_MASK) >> GBC_OAM_SPRITE_MOSAIC_Y_SHIFT;
-
-                // Find the pixel on the sprite
-                x_on_sprite = x - sprite_x;
-                y_on_sprite = self->line_y - sprite_y;
-
-                // Apply flip flags
-                flip_x = (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_FLIP_FLAG_X) >> 5; // Flip becomes 1
-                x_on_sprite = x_on_sprite + (BOOL_MASK[flip_x] & (sprite_w - (x_on_sprite << 1) - 1)); // pixel_x = flip_x ? sprite_w - pixel_x - 1 : pixel_x
-                flip_y = (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_FLIP_FLAG_Y) >> 6; // Flip becomes 1
-                y_on_sprite = y_on_sprite + (BOOL_MASK[flip_y] & (sprite_h - (y_on_sprite << 1) - 1)); // pixel_y = flip_y ? sprite_w - pixel_y - 1 : pixel_y
+                sprite_step = &self->line_sprite_steps[sprite_line_index];
+                sprite_w = sprite_cache->width[sprite_id];
+                sprite_h = sprite_cache->height[sprite_id];
+            #if GBC_CONFIG_MOSAIC
+                sprite_mos_x = sprite_cache->mosaic_x[sprite_id];
+                sprite_mos_y = sprite_cache->mosaic_y[sprite_id];
+            #else
+                sprite_mos_x = sprite_mos_y = 0; // Mosaic is compiled out
+            #endif
+
+                // Check if the pixel we're rendering is within the sprite, flips are already applied to the step
+                on_sprite = (uint32_t)sprite_step->u < ((uint32_t)sprite_w << 8) && (uint32_t)sprite_step->v < ((uint32_t)sprite_h << 8);
+
+                // Find the pixel on the sprite, staying on the sprite's tiles when outside it
+                x_on_sprite = (sprite_step->u >> 8) & BOOL_MASK[on_sprite];
+                y_on_sprite = (sprite_step->v >> 8) & BOOL_MASK[on_sprite];
+
+                // Step to the next pixel
+                sprite_step->u += sprite_step->du;
+                sprite_step->v += sprite_step->dv;
 
                 tile_x = x_on_sprite >> 3; // (x - sprite_x) / GBC_TILE_WIDTH (8)
                 tile_y = y_on_sprite >> 3; // (y - sprite_y) / GBC_TILE_HEIGHT (8)
                 sprite_tile_offset = tile_x + (tile_y * (sprite_w >> 3)); // tile_x + tile_y * (sprite_w / tile_width)
-                offset = (sprite[GBC_OAM_TILE_POS_BYTE] + sprite_tile_offset) << 5; // (tile_num + sprite_tile_offset) * GBC_TILE_NUM_BYTES (32)
-                tile = self->vram + (((sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_VRAM_BANK_MASK) >> 3) << 13) + offset; // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES (8192) + offset
+                tile = sprite_cache->tiles[sprite_id] + (sprite_tile_offset << 5); // sprite's first tile + sprite_tile_offset * GBC_TILE_NUM_BYTES (32)
 
                 // Find the pixel on this tile
                 pixel_x = (x_on_sprite & 7) >> sprite_mos_x; // tile_x % GBC_TILE_WIDTH (8) / 2^sprite_mos_x
@@ -513,74 +1398,64 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
                 pixel = 0b1111 & (pixel_byte >> shift);
 
                 // Check if pixel is actually on the sprite
-                pixel = pixel & BOOL_MASK[x >= sprite_x && x < (sprite_x + sprite_w)];
+                pixel = pixel & BOOL_MASK[on_sprite];
 
                 // Hide pixel if sprites disabled
-                pixel = pixel & BOOL_MASK[(self->lcdc & GBC_LCDC_SPRITE_ENABLE_FLAG) != 0];
+                pixel = pixel & BOOL_MASK[(*self->render_lcdc & GBC_LCDC_SPRITE_ENABLE_FLAG) != 0];
 
-                new_pixel_color = self->sprite_palette_bank[((sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_PALETTE_MASK) << 4) + pixel]; // (tile_attr & GBC_ATTR_PALETTE_MASK) * GBC_PALETTE_NUM_BYTES + pixel
+                new_pixel_color = sprite_palettes[sprite_cache->palette_offsets[sprite_id] + pixel]; // palette_num * GBC_PALETTE_NUM_BYTES + pixel
                 
                 // Now replace the pixel if we have a color
                 pixel_color = (pixel_color & BOOL_MASK[pixel == 0]) + (new_pixel_color & BOOL_MASK[pixel != 0]);
+            #if defined(PBL_BW)
+                pixel_dither_masks = pixel != 0 ? sprite_dither_masks : pixel_dither_masks;
+            #endif
             }
             
             // And last, draw the backgrounds above the sprite layer
             for (bg_num = sprite_layer_z + 1; bg_num < self->num_backgrounds; bg_num++) {
-                if ((self->lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) continue;
-                
-                map_x = (x - self->screen_x_origin) + self->bg_scroll_x[bg_num];
-                map_y = self->line_y + self->bg_scroll_y[bg_num];
-                tile = self->vram + (bg_num << 10) + offset; // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES + offset
-                tilemap = self->bg_tilemaps + (bg_num << 10); // self->bg_tilemaps + bg_num * GBC_TILEMAP_NUM_BYTES
-                attrmap = self->bg_attrmaps + (bg_num << 10); // self->bg_attrmaps + bg_num * GBC_ATTRMAP_NUM_BYTES
-
-                // Find the tile that the pixel is on
-                map_tile_x = map_x >> 3; // map_x / GBC_TILE_WIDTH
-                map_tile_y = map_y >> 3; // map_y / GBC_TILE_HEIGHT
-
-                // Get the tile and attrs from the map
-                tile_num = tilemap[map_tile_x + (map_tile_y << 5)]; // map_tile_y * MAP_WIDTH ??? what ???
-                tile_attr = attrmap[map_tile_x + (map_tile_y << 5)];
-
-                if (tile_attr & GBC_ATTR_HIDE_FLAG) continue;
+                if ((*self->render_lcdc & (GBC_LCDC_BG_1_ENABLE_FLAG << bg_num)) == 0) continue;
                 
-                // Get the tile from vram
-                offset = tile_num << 5; // tile_num * GBC_TILE_NUM_BYTES
-                tile = self->vram + ((((tile_attr & GBC_ATTR_VRAM_BANK_MASK) >> 3)) << 13) + offset; // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES + offset
-
-                // Next, we extract and return the 4bpp pixel from the tile
-                pixel_x = map_x & 7; // map_x % GBC_TILE_WIDTH
-                pixel_y = map_y & 7; // map_x % GBC_TILE_HEIGHT
-
-                // Apply flip flags if necessary
-                flip_x = (tile_attr & GBC_ATTR_FLIP_FLAG_X) != 0; // Flip becomes 1
-                pixel_x = pixel_x + (BOOL_MASK[flip_x] & (GBC_TILE_WIDTH - (pixel_x << 1) - 1)); // pixel_x = flip_x ? sprite_w - pixel_x - 1 : pixel_x
-                flip_y = (tile_attr & GBC_ATTR_FLIP_FLAG_Y) != 0; // Flip becomes 1
-                pixel_y = pixel_y + (BOOL_MASK[flip_y] & (GBC_TILE_HEIGHT - (pixel_y << 1) - 1)); // pixel_y = flip_y ? sprite_w - pixel_y - 1 : pixel_y
-
-                // To get the pixel, we first need to get the corresponding byte the pixel is in
-                // There are 4 bytes per row (y * 4), and 2 pixels per byte (x / 2)
-                offset = (pixel_y << 2) + (pixel_x >> 1); // pixel y * 4 + pixel_x / 2
-                pixel_byte = tile[offset];
+                // Mosaic backgrounds only find a new pixel at the start of each block, then repeat it for the rest
+                bg_step = &self->line_bg_steps[bg_num];
+                if (bg_cache_line[bg_num] != NULL) {
+                    // Up to date cached backgrounds only need to read the pixel back
+                    bg_mosaic_pixel[bg_num] = bg_cache_line[bg_num][x - self->screen_x_origin];
+                    bg_mosaic_color[bg_num] = bg_palettes[bg_mosaic_pixel[bg_num] & (GBC_PALETTE_BANK_NUM_BYTES - 1)];
+                } else if (bg_direct_line[bg_num] != NULL) {
+                    // Copied direct color lines only need a lookup to see if the pixel is clear
+                    bg_mosaic_color[bg_num] = bg_direct_line[bg_num][x - min_x];
+                    bg_mosaic_pixel[bg_num] = (bg_mosaic_color[bg_num] & GBC_DIRECT_COLOR_ALPHA_MASK) ? GBC_DIRECT_COLOR_PIXEL : GBC_BG_NO_PIXEL;
+                    bg_mosaic_color[bg_num] = direct_pixel_color(bg_mosaic_color[bg_num]);
+                } else if (bg_mosaic_count[bg_num] == 0) {
+                    bg_mosaic_pixel[bg_num] = get_bg_pixel(self, bg_num, bg_step->u, bg_step->v, bg_palettes, &bg_mosaic_color[bg_num]);
+                    bg_mosaic_count[bg_num] = bg_mosaic_width[bg_num];
+                }
+                bg_mosaic_count[bg_num]--;
 
-                // Once we have the byte, we need to get the 4 bit pixel out of the byte
-                // This is achieved by shifting the byte (1 - x % 2) * (4 bits per pixel)
-                shift = (1 ^ (pixel_x & 1)) << 2; // (1 - pixel_x % 2) * 4
+                // Step to the next pixel
+                bg_step->u += bg_step->du;
+                bg_step->v += bg_step->dv;
 
-                // We shift the byte and get rid of any unwanted bits
-                pixel = 0b1111 & (pixel_byte >> shift);
+                if (bg_cache_fill_line[bg_num] != NULL) {
+                    bg_cache_fill_line[bg_num][x - self->screen_x_origin] = bg_mosaic_pixel[bg_num];
+                }
 
-                // Finally, we get the corresponding color from attribute palette
-                new_pixel_color = self->bg_palette_bank[((tile_attr & GBC_ATTR_PALETTE_MASK) << 4) + pixel]; // (tile_attr & GBC_ATTR_PALETTE_MASK) * GBC_PALETTE_NUM_BYTES + pixel
+                pixel = bg_mosaic_pixel[bg_num];
+                if (pixel == GBC_BG_NO_PIXEL) continue;
+                pixel &= 0x0F; // Just the pixel number, without its palette's offset
+                new_pixel_color = bg_mosaic_color[bg_num];
 
+            #if GBC_CONFIG_ALPHA
                 // Check if we should do an alpha blend
                 alpha_enabled = (self->a_mode & (GBC_ALPHA_MODE_BG_ENABLED_FLAG << (bg_num << 2))) != 0;
                 alpha_mode = (((self->a_mode & (GBC_ALPHA_MODE_MASK << (bg_num << 2))) >> (bg_num << 2)) >> GBC_ALPHA_MODE_SHIFT) & BOOL_MASK[alpha_enabled];
+            #endif
                 
                 // Create the alpha blends
                 // Mode 0: Normal
                 alpha_mode_result = (pixel_color & BOOL_MASK[pixel == 0 && bg_num != 0]) + (new_pixel_color & BOOL_MASK[pixel != 0 || bg_num == 0]);
-            #if defined(PBL_COLOR)
+            #if GBC_CONFIG_ALPHA && defined(PBL_COLOR)
                 switch(alpha_mode) {
                     case 1:
                         // Mode 1: Add
@@ -631,7 +1506,7 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
                         );
                         break;
                 }
-            #else
+            #elif GBC_CONFIG_ALPHA
                 switch (alpha_mode) {
                     case 1:
                         // Mode 1: Add
@@ -662,12 +1537,16 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
 
                 // Now pick the appropriate alpha result
                 pixel_color = alpha_mode_result;
+            #if defined(PBL_BW)
+                // The pixel takes the dither of the top layer drawn on it
+                pixel_dither_masks = (pixel != 0 || bg_num == 0) ? bg_dither_masks[bg_num] : pixel_dither_masks;
+            #endif
             }
 
         #if defined(PBL_COLOR)
             memset(&info.data[x], pixel_color, 1);
         #else
-            pixel_color = (pixel_color >> 1) & ((pixel_color & 1) | ((x + self->line_y) & 0b11));
+            pixel_color = (pixel_dither_masks[pixel_color & 0b11] >> (x & 7)) & 1; // Look the pixel up in its layer's dither row
             uint16_t byte = (x >> 3); // x / 8
             uint8_t bit = x & 7; // x % 8
             uint8_t *byte_mod = &info.data[byte];
@@ -676,15 +1555,34 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
 
         }
 
+        // Step the affine backgrounds to the next line
+        for (bg_num = 0; bg_num < self->num_backgrounds; bg_num++) {
+            self->bg_affine_line_x[bg_num] += self->bg_affine_params[bg_num * GBC_AFFINE_MATRIX_NUM_VALUES + 1]; // line_x + dmx
+            self->bg_affine_line_y[bg_num] += self->bg_affine_params[bg_num * GBC_AFFINE_MATRIX_NUM_VALUES + 3]; // line_y + dmy
+        }
+
         // Now we're in the HBlank state, run the callback
         self->stat |= GBC_STAT_HBLANK_FLAG;
-        if (self->stat & GBC_STAT_HBLANK_INT_FLAG) {
+        if (on_screen && (self->stat & GBC_STAT_HBLANK_INT_FLAG)) {
             self->hblank_interrupt_callback(self);
         }
     }
     self->stat &= ~GBC_STAT_LINE_COMP_FLAG; // Clear line compare flag
 
-    graphics_release_frame_buffer(ctx, fb);
+    // Caches that were rendered into without changing along the way are now up to date
+    self->bg_cache_valid |= self->bg_cache_filling;
+    self->bg_cache_filling = 0x00;
+    return true;
+}
+
+/**
+ * Finishes the frame on screen, moving on the state that steps once per frame and running the end of frame callbacks
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ */
+static void finish_frame(GBC_Graphics *self) {
+    // Rotate the sprites kept by the line limit for the next frame
+    self->sprite_flicker_offset += self->sprite_line_limit & BOOL_MASK[self->sprite_flicker_enabled];
 
     // Finished drawing sprites, call OAM callback
     self->stat |= GBC_STAT_OAM_FLAG;
@@ -692,6 +1590,10 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
         self->oam_interrupt_callback(self);
     }
 
+    // The frame shows every palette change so far, so start tracking them again, and step the palette animations for the next frame
+    self->dirty_palettes = 0x0000;
+    step_palette_animations(self);
+
     // Done drawing, now we're in VBlank, run the callback
     self->stat |= GBC_STAT_VBLANK_FLAG;
     if (self->stat & GBC_STAT_VBLANK_INT_FLAG) {
@@ -710,7 +1612,34 @@ void GBC_Graphics_render(GBC_Graphics *self) {
  * @param ctx A pointer to the graphics context
  */
 static void graphics_update_proc(Layer *layer, GContext *ctx) {
-    render_graphics(*(GBC_Graphics * *)layer_get_data(layer), layer, ctx);
+    GBC_Graphics *self = *(GBC_Graphics * *)layer_get_data(layer);
+    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+    bool drawn = render_graphics(self, fb, true);
+    graphics_release_frame_buffer(ctx, fb);
+    if (drawn) {
+        finish_frame(self);
+    }
+}
+
+void GBC_Graphics_render_to_bitmap(GBC_Graphics *self, GBitmap *bitmap) {
+    if (gbitmap_get_format(bitmap) != GBC_FRAMEBUFFER_FORMAT) return;
+    uint8_t stat = self->stat, line_y = self->line_y; // The LCD state is left as the last frame on screen left it
+    render_graphics(self, bitmap, false);
+    self->stat = stat;
+    self->line_y = line_y;
+}
+
+void GBC_Graphics_shadow_set_enabled(GBC_Graphics *self, bool enabled) {
+    free(self->shadow_buffer);
+    self->shadow_buffer = enabled ? (uint8_t*)malloc(layout_render_copies(self, NULL)) : NULL;
+    layout_render_copies(self, self->shadow_buffer); // Copy the registers over, or point back at them
+    self->fade_dirty_palettes = 0xFFFF; // The palettes are read from somewhere else now
+}
+
+void GBC_Graphics_shadow_latch(GBC_Graphics *self) {
+    if (self->shadow_buffer == NULL) return;
+    layout_render_copies(self, self->shadow_buffer);
+    self->fade_dirty_palettes = 0xFFFF; // The render copies of the palettes may have changed
 }
 
 void GBC_Graphics_lcdc_set(GBC_Graphics *self, uint8_t new_lcdc) {
@@ -734,13 +1663,53 @@ void GBC_Graphics_lcdc_set_sprite_layer_z(GBC_Graphics *self, uint8_t layer_z) {
 }
 
 void GBC_Graphics_alpha_mode_set_bg_enabled(GBC_Graphics *self, uint8_t bg_num, bool enabled) {
+#if GBC_CONFIG_ALPHA
     modify_word(&self->a_mode, GBC_ALPHA_MODE_BG_ENABLED_FLAG << (bg_num * 4), enabled, GBC_ALPHA_MODE_BG_ENABLED_FLAG << (bg_num * 4));
+#endif
 }
 
 void GBC_Graphics_alpha_mode_set_mode(GBC_Graphics *self, uint8_t bg_num, uint8_t mode) {
+#if GBC_CONFIG_ALPHA
     modify_word(&self->a_mode, GBC_ALPHA_MODE_MASK << (bg_num * 4), mode, GBC_ALPHA_MODE_START << (bg_num * 4));
+#endif
 }
 
+void GBC_Graphics_dither_set_bg_mode(GBC_Graphics *self, uint8_t bg_num, uint8_t mode) {
+    modify_word(&self->dither_mode, GBC_DITHER_MODE_MASK << (bg_num * 2), mode, GBC_DITHER_MODE_START << (bg_num * 2));
+}
+
+void GBC_Graphics_dither_set_sprite_mode(GBC_Graphics *self, uint8_t mode) {
+    modify_word(&self->dither_mode, GBC_DITHER_MODE_MASK << GBC_DITHER_SPRITE_SHIFT, mode, GBC_DITHER_MODE_START << GBC_DITHER_SPRITE_SHIFT);
+}
+
+uint8_t GBC_Graphics_dither_get_bg_mode(GBC_Graphics *self, uint8_t bg_num) {
+    return (self->dither_mode >> (bg_num * 2)) & GBC_DITHER_MODE_MASK;
+}
+
+uint8_t GBC_Graphics_dither_get_sprite_mode(GBC_Graphics *self) {
+    return (self->dither_mode >> GBC_DITHER_SPRITE_SHIFT) & GBC_DITHER_MODE_MASK;
+}
+
+void GBC_Graphics_fade_set_targets(GBC_Graphics *self, uint8_t targets) {
+    self->fade_targets = targets;
+}
+
+void GBC_Graphics_fade_set_color(GBC_Graphics *self, uint8_t color) {
+    self->fade_color = color;
+}
+
+void GBC_Graphics_fade_set_amount(GBC_Graphics *self, uint8_t amount) {
+    self->fade_amount = GBC_MIN(amount, GBC_FADE_MAX);
+}
+
+void GBC_Graphics_fade_set_brightness(GBC_Graphics *self, int8_t brightness) {
+#if defined(PBL_COLOR)
+    GBC_Graphics_fade_set_color(self, brightness < 0 ? GBC_MAKE_COLOR(0, 0, 0) : GBC_MAKE_COLOR(0b11, 0b11, 0b11));
+#else
+    GBC_Graphics_fade_set_color(self, brightness < 0 ? GBC_COLOR_BLACK : GBC_COLOR_WHITE);
+#endif
+    GBC_Graphics_fade_set_amount(self, brightness < 0 ? -brightness : brightness);
+}
 
 uint8_t GBC_Graphics_stat_get_current_line(GBC_Graphics *self) {
     return self->line_y;
@@ -830,134 +1799,365 @@ bool GBC_Graphics_attr_is_hidden(uint8_t attributes) {
     return (bool)(attributes & GBC_ATTR_HIDE_FLAG);
 }
 
-uint8_t GBC_Graphics_bg_get_scroll_x(GBC_Graphics *self, uint8_t bg_layer) {
+short GBC_Graphics_bg_get_scroll_x(GBC_Graphics *self, uint8_t bg_layer) {
     return self->bg_scroll_x[bg_layer];
 }
 
-uint8_t GBC_Graphics_bg_get_scroll_y(GBC_Graphics *self, uint8_t bg_layer) {
+short GBC_Graphics_bg_get_scroll_y(GBC_Graphics *self, uint8_t bg_layer) {
     return self->bg_scroll_y[bg_layer];
 }
 
+uint8_t GBC_Graphics_bg_get_map_width(GBC_Graphics *self, uint8_t bg_layer) {
+    return 1 << ((self->bg_map_sizes[bg_layer] & GBC_MAP_SIZE_WIDTH_MASK) >> GBC_MAP_SIZE_WIDTH_SHIFT);
+}
+
+uint8_t GBC_Graphics_bg_get_map_height(GBC_Graphics *self, uint8_t bg_layer) {
+    return 1 << (self->bg_map_sizes[bg_layer] & GBC_MAP_SIZE_HEIGHT_MASK);
+}
+
 uint8_t GBC_Graphics_bg_get_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
-    return (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)];
+    return get_map_tile(self, bg_layer, x, y);
+}
+
+uint16_t GBC_Graphics_bg_get_wide_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+    uint16_t tile_number = get_map_tile(self, bg_layer, x, y);
+    if (!(self->bg_map_sizes[bg_layer] & GBC_MAP_WIDE_TILES_FLAG)) {
+        tile_number |= (*get_map_attr(self, bg_layer, x, y) & GBC_ATTR_VRAM_BANK_MASK) << 5; // tile_number + vram_bank * 256
+    }
+    return tile_number;
 }
 
 uint8_t GBC_Graphics_bg_get_attr(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
-    return (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)];
+    return *get_map_attr(self, bg_layer, x, y);
 }
 
 void GBC_Graphics_bg_move(GBC_Graphics *self, uint8_t bg_layer, short dx, short dy) {
     short new_x = self->bg_scroll_x[bg_layer] + dx;
     short new_y = self->bg_scroll_y[bg_layer] + dy;
+    short map_width = GBC_Graphics_bg_get_map_width(self, bg_layer) * GBC_TILE_WIDTH;
+    short map_height = GBC_Graphics_bg_get_map_height(self, bg_layer) * GBC_TILE_HEIGHT;
 
     if (new_x < 0) { // Wrap x 
-        new_x = GBC_TILEMAP_WIDTH * GBC_TILE_WIDTH + new_x;
+        new_x = map_width + new_x;
     } else {
-        new_x = new_x % (GBC_TILEMAP_WIDTH * GBC_TILE_WIDTH);
+        new_x = new_x % map_width;
     }
 
     if (new_y < 0) { // Wrap y
-        new_y = GBC_TILEMAP_HEIGHT * GBC_TILE_HEIGHT + new_y;
+        new_y = map_height + new_y;
     } else {
-        new_y = new_y % (GBC_TILEMAP_HEIGHT * GBC_TILE_HEIGHT);
+        new_y = new_y % map_height;
     }
 
     self->bg_scroll_x[bg_layer] = new_x;
     self->bg_scroll_y[bg_layer] = new_y;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
-void GBC_Graphics_bg_set_scroll_x(GBC_Graphics *self, uint8_t bg_layer, uint8_t x) {
+void GBC_Graphics_bg_set_scroll_x(GBC_Graphics *self, uint8_t bg_layer, short x) {
     self->bg_scroll_x[bg_layer] = x;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
-void GBC_Graphics_bg_set_scroll_y(GBC_Graphics *self, uint8_t bg_layer, uint8_t y) {
+void GBC_Graphics_bg_set_scroll_y(GBC_Graphics *self, uint8_t bg_layer, short y) {
     self->bg_scroll_y[bg_layer] = y;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
-void GBC_Graphics_bg_set_scroll_pos(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+void GBC_Graphics_bg_set_scroll_pos(GBC_Graphics *self, uint8_t bg_layer, short x, short y) {
     self->bg_scroll_x[bg_layer] = x;
     self->bg_scroll_y[bg_layer] = y;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t tile_number) {
-    (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)] = tile_number;
+    set_map_tile(self, bg_layer, x, y, tile_number);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_wide_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint16_t tile_number) {
+    tile_number &= GBC_WIDE_TILE_MASK;
+    set_map_tile(self, bg_layer, x, y, tile_number);
+    if (!(self->bg_map_sizes[bg_layer] & GBC_MAP_WIDE_TILES_FLAG)) {
+        modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_VRAM_BANK_MASK, tile_number >> 8, GBC_ATTR_VRAM_BANK_START);
+    }
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_attrs(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t attributes) {
-    (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)] = attributes;
+    *get_map_attr(self, bg_layer, x, y) = attributes;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_and_attrs(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t tile_number, uint8_t attributes) {
-    (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)] = tile_number;
-    (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)] = attributes;
+    set_map_tile(self, bg_layer, x, y, tile_number);
+    *get_map_attr(self, bg_layer, x, y) = attributes;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_palette(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t palette) {
-    modify_byte(&(self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)], GBC_ATTR_PALETTE_MASK, palette, GBC_ATTR_PALETTE_START);
+    modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_PALETTE_MASK, palette, GBC_ATTR_PALETTE_START);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_vram_bank(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t vram_bank) {
-    modify_byte(&(self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)], GBC_ATTR_VRAM_BANK_MASK, vram_bank, GBC_ATTR_VRAM_BANK_START);
+    modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_VRAM_BANK_MASK, vram_bank, GBC_ATTR_VRAM_BANK_START);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_x_flip(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool flipped) {
-    modify_byte(&(self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)], GBC_ATTR_FLIP_FLAG_X, flipped, GBC_ATTR_FLIP_FLAG_X);
+    modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_FLIP_FLAG_X, flipped, GBC_ATTR_FLIP_FLAG_X);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_y_flip(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool flipped) {
-    modify_byte(&(self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)], GBC_ATTR_FLIP_FLAG_Y, flipped, GBC_ATTR_FLIP_FLAG_Y);
+    modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_FLIP_FLAG_Y, flipped, GBC_ATTR_FLIP_FLAG_Y);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_set_tile_hidden(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool hidden) {
-    modify_byte(&(self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(x, y)], GBC_ATTR_HIDE_FLAG, hidden, GBC_ATTR_HIDE_FLAG);
+    modify_byte(get_map_attr(self, bg_layer, x, y), GBC_ATTR_HIDE_FLAG, hidden, GBC_ATTR_HIDE_FLAG);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
 void GBC_Graphics_bg_move_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t src_x, uint8_t src_y, uint8_t dest_x, uint8_t dest_y, bool swap) {
-    uint8_t src_tile = (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(src_x, src_y)];
-    uint8_t src_attr = (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(src_x, src_y)];
-    uint8_t dest_tile = (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(dest_x, dest_y)];
-    uint8_t dest_attr = (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(dest_x, dest_y)];
-    (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(dest_x, dest_y)] = src_tile;
-    (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(dest_x, dest_y)] = src_attr;
+    uint16_t src_tile = get_map_tile(self, bg_layer, src_x, src_y);
+    uint8_t src_attr = *get_map_attr(self, bg_layer, src_x, src_y);
+    uint16_t dest_tile = get_map_tile(self, bg_layer, dest_x, dest_y);
+    uint8_t dest_attr = *get_map_attr(self, bg_layer, dest_x, dest_y);
+    set_map_tile(self, bg_layer, dest_x, dest_y, src_tile);
+    *get_map_attr(self, bg_layer, dest_x, dest_y) = src_attr;
 
     if (swap) {
-        (self->bg_tilemaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(src_x, src_y)] = dest_tile;
-        (self->bg_attrmaps + bg_layer * GBC_TILEMAP_NUM_BYTES)[GBC_POINT_TO_OFFSET(src_x, src_y)] = dest_attr;
+        set_map_tile(self, bg_layer, src_x, src_y, dest_tile);
+        *get_map_attr(self, bg_layer, src_x, src_y) = dest_attr;
     }
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
 }
 
-uint16_t GBC_Graphics_oam_get_sprite_x(GBC_Graphics *self, uint8_t sprite_num) {
+void GBC_Graphics_bg_set_affine_enabled(GBC_Graphics *self, uint8_t bg_layer, bool enabled) {
+    modify_byte(&self->bg_affine, GBC_BG_AFFINE_ENABLE_FLAG << bg_layer, enabled, GBC_BG_AFFINE_ENABLE_FLAG << bg_layer);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_affine_clipped(GBC_Graphics *self, uint8_t bg_layer, bool clipped) {
+    modify_byte(&self->bg_affine, GBC_BG_AFFINE_CLIP_FLAG << bg_layer, clipped, GBC_BG_AFFINE_CLIP_FLAG << bg_layer);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_affine_params(GBC_Graphics *self, uint8_t bg_layer, int16_t dx, int16_t dmx, int16_t dy, int16_t dmy) {
+    int16_t *params = &self->bg_affine_params[bg_layer * GBC_AFFINE_MATRIX_NUM_VALUES];
+    params[0] = dx;
+    params[1] = dmx;
+    params[2] = dy;
+    params[3] = dmy;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_affine_ref_point(GBC_Graphics *self, uint8_t bg_layer, int32_t x, int32_t y) {
+    self->bg_affine_ref_x[bg_layer] = x;
+    self->bg_affine_ref_y[bg_layer] = y;
+    self->bg_affine_line_x[bg_layer] = x;
+    self->bg_affine_line_y[bg_layer] = y;
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+/**
+ * Keeps an affine rotation scale at least GBC_AFFINE_SCALE_MIN either way around, so dividing by it can't overflow the parameters
+ * 
+ * @param scale The scale in 8.8 fixed point, negative to mirror
+ * 
+ * @return The scale, with zero and anything smaller than the minimum moved out to the minimum
+ */
+static int16_t clamp_affine_scale(int16_t scale) {
+    if (scale < 0) return GBC_MIN(scale, -GBC_AFFINE_SCALE_MIN);
+    return GBC_MAX(scale, GBC_AFFINE_SCALE_MIN);
+}
+
+void GBC_Graphics_bg_set_affine_rotation_scale(GBC_Graphics *self, uint8_t bg_layer, int32_t angle, int16_t scale_x, int16_t scale_y, 
+                                               short map_x, short map_y, short screen_x, short screen_y) {
+    scale_x = clamp_affine_scale(scale_x);
+    scale_y = clamp_affine_scale(scale_y);
+
+    // Like the sprite matrices, the parameters map the screen onto the map, so they're the inverse rotation and scale
+    int32_t cos = cos_lookup(angle) * GBC_AFFINE_ONE / TRIG_MAX_RATIO;
+    int32_t sin = sin_lookup(angle) * GBC_AFFINE_ONE / TRIG_MAX_RATIO;
+    int16_t dx = cos * GBC_AFFINE_ONE / scale_x;
+    int16_t dmx = sin * GBC_AFFINE_ONE / scale_x;
+    int16_t dy = -sin * GBC_AFFINE_ONE / scale_y;
+    int16_t dmy = cos * GBC_AFFINE_ONE / scale_y;
+    GBC_Graphics_bg_set_affine_params(self, bg_layer, dx, dmx, dy, dmy);
+
+    // Work back from the map point to the map position at the top left of the screen
+    GBC_Graphics_bg_set_affine_ref_point(self, bg_layer, 
+        map_x * GBC_AFFINE_ONE - dx * screen_x - dmx * screen_y,
+        map_y * GBC_AFFINE_ONE - dy * screen_x - dmy * screen_y);
+}
+
+#if GBC_CONFIG_MOSAIC
+void GBC_Graphics_bg_set_mosaic(GBC_Graphics *self, uint8_t bg_layer, uint8_t width, uint8_t height) {
+    width = GBC_MIN(GBC_MAX(width, 1), GBC_BG_MOSAIC_MAX_SIZE);
+    height = GBC_MIN(GBC_MAX(height, 1), GBC_BG_MOSAIC_MAX_SIZE);
+    modify_byte(&self->bg_mosaic[bg_layer], GBC_BG_MOSAIC_WIDTH_MASK, width - 1, GBC_BG_MOSAIC_WIDTH_START);
+    modify_byte(&self->bg_mosaic[bg_layer], GBC_BG_MOSAIC_HEIGHT_MASK, height - 1, GBC_BG_MOSAIC_HEIGHT_START);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+uint8_t GBC_Graphics_bg_get_mosaic_width(GBC_Graphics *self, uint8_t bg_layer) {
+    return ((self->bg_mosaic[bg_layer] & GBC_BG_MOSAIC_WIDTH_MASK) >> GBC_BG_MOSAIC_WIDTH_SHIFT) + 1;
+}
+
+uint8_t GBC_Graphics_bg_get_mosaic_height(GBC_Graphics *self, uint8_t bg_layer) {
+    return ((self->bg_mosaic[bg_layer] & GBC_BG_MOSAIC_HEIGHT_MASK) >> GBC_BG_MOSAIC_HEIGHT_SHIFT) + 1;
+}
+#else
+void GBC_Graphics_bg_set_mosaic(GBC_Graphics *self, uint8_t bg_layer, uint8_t width, uint8_t height) {
+    // Mosaic is compiled out, so there's no register to set
+}
+
+uint8_t GBC_Graphics_bg_get_mosaic_width(GBC_Graphics *self, uint8_t bg_layer) {
+    return 1;
+}
+
+uint8_t GBC_Graphics_bg_get_mosaic_height(GBC_Graphics *self, uint8_t bg_layer) {
+    return 1;
+}
+#endif
+
+void GBC_Graphics_bg_set_direct_color_enabled(GBC_Graphics *self, uint8_t bg_layer, bool enabled) {
+    if (enabled && self->line_direct_pixels == NULL) {
+        self->line_direct_pixels = (uint8_t*)malloc(self->num_backgrounds << 8); // 256 bytes per background
+        if (self->line_direct_pixels == NULL) return; // Out of memory, so the background keeps drawing its tilemap
+    }
+    modify_byte(&self->bg_direct_color, GBC_BG_DIRECT_COLOR_FLAG << bg_layer, enabled, GBC_BG_DIRECT_COLOR_FLAG << bg_layer);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_cached(GBC_Graphics *self, uint8_t bg_layer, bool cached) {
+    modify_byte(&self->bg_cached, GBC_BG_CACHE_FLAG << bg_layer, cached, GBC_BG_CACHE_FLAG << bg_layer);
+    allocate_bg_cache(self, bg_layer);
+}
+
+void GBC_Graphics_bg_invalidate_cache(GBC_Graphics *self, uint8_t bg_layer) {
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+void GBC_Graphics_bg_set_direct_image(GBC_Graphics *self, uint8_t bg_layer, uint8_t *pixels, uint16_t width, uint16_t height) {
+    self->bg_direct_images[bg_layer].pixels = pixels;
+    self->bg_direct_images[bg_layer].width = GBC_MIN(width, GBC_Graphics_bg_get_map_width(self, bg_layer) * GBC_TILE_WIDTH);
+    self->bg_direct_images[bg_layer].height = GBC_MIN(height, GBC_Graphics_bg_get_map_height(self, bg_layer) * GBC_TILE_HEIGHT);
+    invalidate_bg_caches(self, GBC_BG_CACHE_FLAG << bg_layer);
+}
+
+uint16_t GBC_Graphics_oam_get_sprite_x(GBC_Graphics *self, uint16_t sprite_num) {
     return self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_X_POS_BYTE] + (((bool)(self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8);
 }
 
-uint16_t GBC_Graphics_oam_get_sprite_y(GBC_Graphics *self, uint8_t sprite_num) {
+uint16_t GBC_Graphics_oam_get_sprite_y(GBC_Graphics *self, uint16_t sprite_num) {
     return self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_Y_POS_BYTE] + (((bool)(self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8);
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_tile(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_tile(GBC_Graphics *self, uint16_t sprite_num) {
     return self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_TILE_POS_BYTE];
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num) {
     return self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE];
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_width(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_width(GBC_Graphics *self, uint16_t sprite_num) {
     return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT;
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_height(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_height(GBC_Graphics *self, uint16_t sprite_num) {
     return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT;
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_mosaic_x(GBC_Graphics *self, uint16_t sprite_num) {
     return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_X_MASK) >> GBC_OAM_SPRITE_MOSAIC_X_SHIFT;
 }
 
-uint8_t GBC_Graphics_oam_get_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_num) {
+uint8_t GBC_Graphics_oam_get_sprite_mosaic_y(GBC_Graphics *self, uint16_t sprite_num) {
     return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_Y_MASK) >> GBC_OAM_SPRITE_MOSAIC_Y_SHIFT;
 }
-void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint8_t sprite_num, uint16_t x, uint16_t y, uint8_t tile_position, uint8_t attributes, uint8_t width, uint8_t height, uint8_t mosaic_x, uint8_t mosaic_y) {
+
+bool GBC_Graphics_oam_is_sprite_affine(GBC_Graphics *self, uint16_t sprite_num) {
+    return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_AFFINE_FLAG) != 0;
+}
+
+uint8_t GBC_Graphics_oam_get_sprite_affine_matrix(GBC_Graphics *self, uint16_t sprite_num) {
+    return (self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_AFFINE_MATRIX_MASK) >> GBC_OAM_SPRITE_AFFINE_MATRIX_SHIFT;
+}
+
+/**
+ * Decodes a sprite's OAM bytes into the sprite cache
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ */
+static void decode_sprite(GBC_Graphics *self, uint16_t sprite_num) {
+    uint8_t *sprite = &self->oam[sprite_num * GBC_SPRITE_NUM_BYTES];
+    GBC_Sprite_Cache *cache = &self->sprite_cache;
+    cache->x[sprite_num] = sprite[GBC_OAM_X_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_X_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_X;
+    cache->y[sprite_num] = sprite[GBC_OAM_Y_POS_BYTE] + (((bool)(sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG)) << 8) - GBC_SPRITE_OFFSET_Y;
+    cache->width[sprite_num] = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_WIDTH_MASK) >> GBC_OAM_SPRITE_WIDTH_SHIFT)) << 3; // sprite_width * tile_width
+    cache->height[sprite_num] = (1 + ((sprite[GBC_OAM_DIMS_BYTE] & GBC_OAM_SPRITE_HEIGHT_MASK) >> GBC_OAM_SPRITE_HEIGHT_SHIFT)) << 3; // sprite_height * tile_height
+    cache->tiles[sprite_num] = self->vram + (((sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_VRAM_BANK_MASK) >> 3) << 13) + (sprite[GBC_OAM_TILE_POS_BYTE] << 5); // self->vram + vram_bank_number * GBC_VRAM_BANK_NUM_BYTES (8192) + tile_num * GBC_TILE_NUM_BYTES (32)
+    cache->palette_offsets[sprite_num] = (sprite[GBC_OAM_ATTR_BYTE] & GBC_ATTR_PALETTE_MASK) << 4; // palette_num * GBC_PALETTE_NUM_BYTES
+    cache->attrs[sprite_num] = sprite[GBC_OAM_ATTR_BYTE];
+    if (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_AFFINE_FLAG) {
+        // Affine sprites use the mosaic bits for their matrix number
+    #if GBC_CONFIG_MOSAIC
+        cache->mosaic_x[sprite_num] = 0;
+        cache->mosaic_y[sprite_num] = 0;
+    #endif
+        cache->affine_matrix[sprite_num] = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_AFFINE_MATRIX_MASK) >> GBC_OAM_SPRITE_AFFINE_MATRIX_SHIFT;
+        cache->size_shift[sprite_num] = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_DOUBLE_SIZE_FLAG) != 0;
+    } else {
+    #if GBC_CONFIG_MOSAIC
+        cache->mosaic_x[sprite_num] = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_X_MASK) >> GBC_OAM_SPRITE_MOSAIC_X_SHIFT;
+        cache->mosaic_y[sprite_num] = (sprite[GBC_OAM_EXTRA_BYTE] & GBC_OAM_SPRITE_MOSAIC_Y_MASK) >> GBC_OAM_SPRITE_MOSAIC_Y_SHIFT;
+    #endif
+        cache->affine_matrix[sprite_num] = GBC_SPRITE_NOT_AFFINE;
+        cache->size_shift[sprite_num] = 0;
+    }
+}
+
+/**
+ * Adds or removes a sprite from the bins of the lines it overlaps, using its decoded position
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param binned Should the sprite be added (true) or removed (false)?
+ */
+static void bin_sprite(GBC_Graphics *self, uint16_t sprite_num, bool binned) {
+    short sprite_top = self->sprite_cache.y[sprite_num];
+    short sprite_bottom = sprite_top + (self->sprite_cache.height[sprite_num] << self->sprite_cache.size_shift[sprite_num]) - 1;
+    
+    // Only lines 0-255 are binned, so clip the sprite to those
+    short first_bin = GBC_MAX(sprite_top, 0) >> GBC_SPRITE_BIN_SHIFT;
+    short last_bin = GBC_MIN(sprite_bottom, 255) >> GBC_SPRITE_BIN_SHIFT;
+    uint32_t *bin_word = self->sprite_bins + first_bin * self->sprite_bin_words + (sprite_num >> 5);
+    uint32_t bit = 1u << (sprite_num & 31);
+    for (short bin = first_bin; bin <= last_bin; bin++) {
+        *bin_word = binned ? (*bin_word | bit) : (*bin_word & ~bit);
+        bin_word += self->sprite_bin_words;
+    }
+}
+
+/**
+ * Re-decodes a sprite and adds it back to the sprite bins, after it was removed with bin_sprite and its OAM changed
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ */
+static void rebin_sprite(GBC_Graphics *self, uint16_t sprite_num) {
+    decode_sprite(self, sprite_num);
+    bin_sprite(self, sprite_num, true);
+}
+
+void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint16_t sprite_num, uint16_t x, uint16_t y, uint8_t tile_position, uint8_t attributes, uint8_t width, uint8_t height, uint8_t mosaic_x, uint8_t mosaic_y) {
+    bin_sprite(self, sprite_num, false);
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_X_POS_BYTE] = (x & 0xFF);
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_Y_POS_BYTE] = (y & 0xFF);
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_TILE_POS_BYTE] = tile_position;
@@ -972,6 +2172,7 @@ void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint8_t sprite_num, uint16_
         ((mosaic_x & (GBC_OAM_SPRITE_MOSAIC_X_MASK >> GBC_OAM_SPRITE_MOSAIC_X_SHIFT)) << GBC_OAM_SPRITE_MOSAIC_X_SHIFT) |
         ((mosaic_y & (GBC_OAM_SPRITE_MOSAIC_Y_MASK >> GBC_OAM_SPRITE_MOSAIC_Y_SHIFT)) << GBC_OAM_SPRITE_MOSAIC_Y_SHIFT)
     );
+    rebin_sprite(self, sprite_num);
 }
 
 /**
@@ -993,7 +2194,7 @@ static uint16_t clamp_short_to_uint16_t(short to_clamp, uint16_t lower_bound, ui
     return (uint16_t) to_clamp;
 }
 
-void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint8_t sprite_num, short dx, short dy) {
+void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint16_t sprite_num, short dx, short dy) {
     short new_x, new_y;
     new_x = GBC_Graphics_oam_get_sprite_x(self, sprite_num) + dx;
     new_y = GBC_Graphics_oam_get_sprite_y(self, sprite_num) + dy;
@@ -1001,112 +2202,931 @@ void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint8_t sprite_num, short
     GBC_Graphics_oam_set_sprite_y(self, sprite_num, clamp_short_to_uint16_t(new_y, 0, GBC_SPRITE_MAX_Y));
 }
 
-void GBC_Graphics_oam_set_sprite_x(GBC_Graphics *self, uint8_t sprite_num, uint16_t x) {
+void GBC_Graphics_oam_set_sprite_x(GBC_Graphics *self, uint16_t sprite_num, uint16_t x) {
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_X_POS_BYTE] = (x & 0xFF);
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_UPPER_X_BIT_FLAG, ((x & 0x0100) >> 8), GBC_OAM_SPRITE_UPPER_X_BIT_FLAG);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_y(GBC_Graphics *self, uint8_t sprite_num, uint16_t y) {
+void GBC_Graphics_oam_set_sprite_y(GBC_Graphics *self, uint16_t sprite_num, uint16_t y) {
+    bin_sprite(self, sprite_num, false);
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_Y_POS_BYTE] = (y & 0xFF);
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG, ((y & 0x0100) >> 8), GBC_OAM_SPRITE_UPPER_Y_BIT_FLAG);
+    rebin_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_pos(GBC_Graphics *self, uint8_t sprite_num, uint16_t x, uint16_t y) {
+void GBC_Graphics_oam_set_sprite_pos(GBC_Graphics *self, uint16_t sprite_num, uint16_t x, uint16_t y) {
     GBC_Graphics_oam_set_sprite_x(self, sprite_num, x);
     GBC_Graphics_oam_set_sprite_y(self, sprite_num, y);
 }
 
-void GBC_Graphics_oam_set_sprite_tile(GBC_Graphics *self, uint8_t sprite_num, uint8_t tile_position) {
+void GBC_Graphics_oam_set_sprite_tile(GBC_Graphics *self, uint16_t sprite_num, uint8_t tile_position) {
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_TILE_POS_BYTE] = tile_position;
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num, uint8_t attributes) {
+void GBC_Graphics_oam_set_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num, uint8_t attributes) {
     self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE] = attributes;
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_palette(GBC_Graphics *self, uint8_t sprite_num, uint8_t palette) {
+void GBC_Graphics_oam_set_sprite_palette(GBC_Graphics *self, uint16_t sprite_num, uint8_t palette) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE], GBC_ATTR_PALETTE_MASK, palette, GBC_ATTR_PALETTE_START);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_vram_bank(GBC_Graphics *self, uint8_t sprite_num, uint8_t vram_bank) {
+void GBC_Graphics_oam_set_sprite_vram_bank(GBC_Graphics *self, uint16_t sprite_num, uint8_t vram_bank) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE], GBC_ATTR_VRAM_BANK_MASK, vram_bank, GBC_ATTR_VRAM_BANK_START);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_x_flip(GBC_Graphics *self, uint8_t sprite_num, bool flipped) {
+void GBC_Graphics_oam_set_sprite_x_flip(GBC_Graphics *self, uint16_t sprite_num, bool flipped) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE], GBC_ATTR_FLIP_FLAG_X, flipped, GBC_ATTR_FLIP_FLAG_X);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_y_flip(GBC_Graphics *self, uint8_t sprite_num, bool flipped) {
+void GBC_Graphics_oam_set_sprite_y_flip(GBC_Graphics *self, uint16_t sprite_num, bool flipped) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE], GBC_ATTR_FLIP_FLAG_Y, flipped, GBC_ATTR_FLIP_FLAG_Y);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_hidden(GBC_Graphics *self, uint8_t sprite_num, bool hidden) {
+void GBC_Graphics_oam_set_sprite_hidden(GBC_Graphics *self, uint16_t sprite_num, bool hidden) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_ATTR_BYTE], GBC_ATTR_HIDE_FLAG, hidden, GBC_ATTR_HIDE_FLAG);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_width(GBC_Graphics *self, uint8_t sprite_num, uint8_t width) {
+void GBC_Graphics_oam_set_sprite_width(GBC_Graphics *self, uint16_t sprite_num, uint8_t width) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_DIMS_BYTE], GBC_OAM_SPRITE_WIDTH_MASK, width, GBC_OAM_SPRITE_WIDTH_START);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_height(GBC_Graphics *self, uint8_t sprite_num, uint8_t height) {
+void GBC_Graphics_oam_set_sprite_height(GBC_Graphics *self, uint16_t sprite_num, uint8_t height) {
+    bin_sprite(self, sprite_num, false);
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_DIMS_BYTE], GBC_OAM_SPRITE_HEIGHT_MASK, height, GBC_OAM_SPRITE_HEIGHT_START);
+    rebin_sprite(self, sprite_num);
 }
 
 
-void GBC_Graphics_oam_set_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_num, uint8_t mosaic_x) {
+void GBC_Graphics_oam_set_sprite_mosaic_x(GBC_Graphics *self, uint16_t sprite_num, uint8_t mosaic_x) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_MOSAIC_X_MASK, mosaic_x, GBC_OAM_SPRITE_MOSAIC_X_START);
+    decode_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_set_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_num, uint8_t mosaic_y) {
+void GBC_Graphics_oam_set_sprite_mosaic_y(GBC_Graphics *self, uint16_t sprite_num, uint8_t mosaic_y) {
     modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_MOSAIC_Y_MASK, mosaic_y, GBC_OAM_SPRITE_MOSAIC_Y_START);
+    decode_sprite(self, sprite_num);
+}
+
+void GBC_Graphics_oam_set_sprite_affine(GBC_Graphics *self, uint16_t sprite_num, bool affine) {
+    bin_sprite(self, sprite_num, false);
+    modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_AFFINE_FLAG, affine, GBC_OAM_SPRITE_AFFINE_FLAG);
+    rebin_sprite(self, sprite_num);
+}
+
+void GBC_Graphics_oam_set_sprite_affine_matrix(GBC_Graphics *self, uint16_t sprite_num, uint8_t matrix_num) {
+    modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_AFFINE_MATRIX_MASK, matrix_num, GBC_OAM_SPRITE_AFFINE_MATRIX_START);
+    decode_sprite(self, sprite_num);
+}
+
+void GBC_Graphics_oam_set_sprite_double_size(GBC_Graphics *self, uint16_t sprite_num, bool double_size) {
+    bin_sprite(self, sprite_num, false);
+    modify_byte(&self->oam[sprite_num * GBC_SPRITE_NUM_BYTES + GBC_OAM_EXTRA_BYTE], GBC_OAM_SPRITE_DOUBLE_SIZE_FLAG, double_size, GBC_OAM_SPRITE_DOUBLE_SIZE_FLAG);
+    rebin_sprite(self, sprite_num);
 }
 
-void GBC_Graphics_oam_change_sprite_num(GBC_Graphics *self, uint8_t source_sprite_num, uint8_t target_sprite_num, bool copy) {
+void GBC_Graphics_oam_change_sprite_num(GBC_Graphics *self, uint16_t source_sprite_num, uint16_t target_sprite_num, bool copy) {
     uint8_t *source = &self->oam[source_sprite_num * GBC_SPRITE_NUM_BYTES];
     uint8_t *target = &self->oam[target_sprite_num * GBC_SPRITE_NUM_BYTES];
+    bin_sprite(self, source_sprite_num, false);
+    bin_sprite(self, target_sprite_num, false);
     for (uint8_t i = 0; i < GBC_SPRITE_NUM_BYTES; i++) {
             target[i] = source[i];
         if (!copy) {
             source[i] = 0;
         }
     }
+    rebin_sprite(self, source_sprite_num);
+    rebin_sprite(self, target_sprite_num);
 }
 
-void GBC_Graphics_oam_swap_sprites(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2) {
+void GBC_Graphics_oam_swap_sprites(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2) {
     uint8_t temp;
     uint8_t *source_1 = &self->oam[sprite_num_1 * GBC_SPRITE_NUM_BYTES];
     uint8_t *source_2 = &self->oam[sprite_num_2 * GBC_SPRITE_NUM_BYTES];
+    bin_sprite(self, sprite_num_1, false);
+    bin_sprite(self, sprite_num_2, false);
     for (uint8_t i = 0; i < GBC_SPRITE_NUM_BYTES; i++) {
         temp = source_1[i];
         source_1[i] = source_2[i];
         source_2[i] = temp;
     }
+    rebin_sprite(self, sprite_num_1);
+    rebin_sprite(self, sprite_num_2);
 }
 
-void GBC_Graphics_oam_swap_sprite_tiles(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2) {
+void GBC_Graphics_oam_swap_sprite_tiles(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2) {
     uint8_t temp;
     uint8_t *source_1 = &self->oam[sprite_num_1 * GBC_SPRITE_NUM_BYTES];
     uint8_t *source_2 = &self->oam[sprite_num_2 * GBC_SPRITE_NUM_BYTES];
     temp = source_1[GBC_OAM_TILE_POS_BYTE];
     source_1[GBC_OAM_TILE_POS_BYTE] = source_2[GBC_OAM_TILE_POS_BYTE];
     source_2[GBC_OAM_TILE_POS_BYTE] = temp;
+    decode_sprite(self, sprite_num_1);
+    decode_sprite(self, sprite_num_2);
 }
 
-void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2) {
+void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2) {
     uint8_t temp;
     uint8_t *source_1 = &self->oam[sprite_num_1 * GBC_SPRITE_NUM_BYTES];
     uint8_t *source_2 = &self->oam[sprite_num_2 * GBC_SPRITE_NUM_BYTES];
     temp = source_1[GBC_OAM_ATTR_BYTE];
     source_1[GBC_OAM_ATTR_BYTE] = source_2[GBC_OAM_ATTR_BYTE];
     source_2[GBC_OAM_ATTR_BYTE] = temp;
+    decode_sprite(self, sprite_num_1);
+    decode_sprite(self, sprite_num_2);
 }
 
-void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2) {
+void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2) {
     GBC_Graphics_oam_swap_sprite_tiles(self, sprite_num_1, sprite_num_2);
     GBC_Graphics_oam_swap_sprite_attrs(self, sprite_num_1, sprite_num_2);
 }
 
+void GBC_Graphics_oam_sync(GBC_Graphics *self) {
+    memset(self->sprite_bins, 0, GBC_SPRITE_NUM_BINS * self->sprite_bin_words * sizeof(uint32_t));
+    for (uint16_t sprite_num = 0; sprite_num < self->num_sprites; sprite_num++) {
+        rebin_sprite(self, sprite_num);
+    }
+}
+
+void GBC_Graphics_oam_set_sprite_line_limit(GBC_Graphics *self, uint8_t limit) {
+    self->sprite_line_limit = limit;
+}
+
+void GBC_Graphics_oam_set_sprite_flicker_enabled(GBC_Graphics *self, bool enabled) {
+    self->sprite_flicker_enabled = enabled;
+}
+
+void GBC_Graphics_oam_set_affine_matrix(GBC_Graphics *self, uint8_t matrix_num, int16_t pa, int16_t pb, int16_t pc, int16_t pd) {
+    int16_t *matrix = &self->sprite_affine_matrices[(matrix_num & (GBC_SPRITE_NUM_AFFINE_MATRICES - 1)) * GBC_AFFINE_MATRIX_NUM_VALUES];
+    matrix[0] = pa;
+    matrix[1] = pb;
+    matrix[2] = pc;
+    matrix[3] = pd;
+}
+
+void GBC_Graphics_oam_set_affine_rotation_scale(GBC_Graphics *self, uint8_t matrix_num, int32_t angle, int16_t scale_x, int16_t scale_y) {
+    scale_x = clamp_affine_scale(scale_x);
+    scale_y = clamp_affine_scale(scale_y);
+
+    // The matrix maps the screen onto the sprite, so it's the inverse: rotate back by the angle, then divide by the scale
+    int32_t cos = cos_lookup(angle) * GBC_AFFINE_ONE / TRIG_MAX_RATIO;
+    int32_t sin = sin_lookup(angle) * GBC_AFFINE_ONE / TRIG_MAX_RATIO;
+    GBC_Graphics_oam_set_affine_matrix(self, matrix_num, 
+        cos * GBC_AFFINE_ONE / scale_x, sin * GBC_AFFINE_ONE / scale_x,
+        -sin * GBC_AFFINE_ONE / scale_y, cos * GBC_AFFINE_ONE / scale_y);
+}
+
 void GBC_Graphics_copy_background(GBC_Graphics *self, uint8_t source_bg_layer, uint8_t target_bg_layer) {
-    memcpy((self->bg_tilemaps + source_bg_layer * GBC_TILEMAP_NUM_BYTES), (self->bg_tilemaps + target_bg_layer * GBC_TILEMAP_NUM_BYTES), GBC_TILEMAP_NUM_BYTES);
-    memcpy((self->bg_attrmaps + source_bg_layer * GBC_ATTRMAP_NUM_BYTES), (self->bg_attrmaps + target_bg_layer * GBC_ATTRMAP_NUM_BYTES), GBC_ATTRMAP_NUM_BYTES);
+    // The maps can be different sizes and tile widths, so copy the rows they share one at a time
+    uint8_t copy_width = GBC_MIN(GBC_Graphics_bg_get_map_width(self, source_bg_layer), GBC_Graphics_bg_get_map_width(self, target_bg_layer));
+    uint8_t copy_height = GBC_MIN(GBC_Graphics_bg_get_map_height(self, source_bg_layer), GBC_Graphics_bg_get_map_height(self, target_bg_layer));
+    for (uint8_t y = 0; y < copy_height; y++) {
+        for (uint8_t x = 0; x < copy_width; x++) {
+            set_map_tile(self, source_bg_layer, x, y, get_map_tile(self, target_bg_layer, x, y));
+        }
+        memcpy(get_map_attr(self, source_bg_layer, 0, y), get_map_attr(self, target_bg_layer, 0, y), copy_width);
+    }
+    invalidate_bg_caches(self, (GBC_BG_CACHE_FLAG << source_bg_layer) | (GBC_BG_CACHE_FLAG << target_bg_layer));
+}
+
+/**
+ * A block of the object's state that snapshots copy as is
+ */
+typedef struct _gbc_snapshot_region {
+    void *data; ///> A pointer to the block
+    uint16_t num_bytes; ///> The size of the block in bytes
+} GBC_Snapshot_Region;
+
+/**
+ * Adds a block of state to the list that a snapshot copies
+ * 
+ * @param regions A pointer to the list of blocks
+ * @param num_regions A pointer to the number of blocks in the list, which is incremented
+ * @param data A pointer to the block
+ * @param num_bytes The size of the block in bytes
+ */
+static void add_snapshot_region(GBC_Snapshot_Region *regions, uint8_t *num_regions, void *data, uint16_t num_bytes) {
+    regions[*num_regions].data = data;
+    regions[*num_regions].num_bytes = num_bytes;
+    (*num_regions)++;
+}
+
+/**
+ * Lists the blocks of state that a snapshot copies, in the order they're stored in the snapshot
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param subsystems The parts of the state to list, see the snapshot flags
+ * @param regions A pointer to where the list will be stored, with room for GBC_SNAPSHOT_MAX_REGIONS blocks
+ * 
+ * @return The number of blocks in the list
+ */
+static uint8_t get_snapshot_regions(GBC_Graphics *self, uint8_t subsystems, GBC_Snapshot_Region *regions) {
+    uint8_t num_regions = 0;
+    uint8_t num_backgrounds = self->num_backgrounds;
+    if (subsystems & GBC_SNAPSHOT_MAPS_FLAG) {
+        uint16_t map_num_tiles = 0, tilemap_num_bytes = 0;
+        for (uint8_t bg_layer = 0; bg_layer < num_backgrounds; bg_layer++) {
+            map_num_tiles += get_map_num_tiles(self->bg_map_sizes[bg_layer]);
+            tilemap_num_bytes += get_tilemap_num_bytes(self->bg_map_sizes[bg_layer]);
+        }
+        add_snapshot_region(regions, &num_regions, self->bg_tilemaps, tilemap_num_bytes);
+        add_snapshot_region(regions, &num_regions, self->bg_attrmaps, map_num_tiles);
+    }
+    if (subsystems & GBC_SNAPSHOT_PALETTES_FLAG) {
+        add_snapshot_region(regions, &num_regions, self->bg_palette_bank, GBC_PALETTE_BANK_NUM_BYTES);
+        add_snapshot_region(regions, &num_regions, self->sprite_palette_bank, GBC_PALETTE_BANK_NUM_BYTES);
+    }
+    if (subsystems & GBC_SNAPSHOT_OAM_FLAG) {
+        add_snapshot_region(regions, &num_regions, self->oam, self->num_sprites * GBC_SPRITE_NUM_BYTES);
+        add_snapshot_region(regions, &num_regions, self->sprite_affine_matrices, GBC_SPRITE_NUM_AFFINE_MATRICES * GBC_AFFINE_MATRIX_NUM_VALUES * sizeof(int16_t));
+    }
+    if (subsystems & GBC_SNAPSHOT_REGISTERS_FLAG) {
+        add_snapshot_region(regions, &num_regions, self->bg_scroll_x, num_backgrounds * sizeof(short));
+        add_snapshot_region(regions, &num_regions, self->bg_scroll_y, num_backgrounds * sizeof(short));
+        add_snapshot_region(regions, &num_regions, self->bg_affine_params, num_backgrounds * GBC_AFFINE_MATRIX_NUM_VALUES * sizeof(int16_t));
+        add_snapshot_region(regions, &num_regions, self->bg_affine_ref_x, num_backgrounds * sizeof(int32_t));
+        add_snapshot_region(regions, &num_regions, self->bg_affine_ref_y, num_backgrounds * sizeof(int32_t));
+    #if GBC_CONFIG_MOSAIC
+        add_snapshot_region(regions, &num_regions, self->bg_mosaic, num_backgrounds);
+    #endif
+        add_snapshot_region(regions, &num_regions, &self->bg_affine, sizeof(self->bg_affine));
+        add_snapshot_region(regions, &num_regions, &self->lcdc, sizeof(self->lcdc));
+        add_snapshot_region(regions, &num_regions, &self->stat, sizeof(self->stat));
+        add_snapshot_region(regions, &num_regions, &self->line_y_compare, sizeof(self->line_y_compare));
+        add_snapshot_region(regions, &num_regions, &self->fade_targets, sizeof(self->fade_targets));
+        add_snapshot_region(regions, &num_regions, &self->fade_color, sizeof(self->fade_color));
+        add_snapshot_region(regions, &num_regions, &self->fade_amount, sizeof(self->fade_amount));
+    #if GBC_CONFIG_ALPHA
+        add_snapshot_region(regions, &num_regions, &self->a_mode, sizeof(self->a_mode));
+    #endif
+        add_snapshot_region(regions, &num_regions, &self->dither_mode, sizeof(self->dither_mode));
+    }
+    if (subsystems & GBC_SNAPSHOT_VRAM_FLAG) {
+        add_snapshot_region(regions, &num_regions, self->vram, self->num_vram_banks * GBC_VRAM_BANK_NUM_BYTES);
+    }
+    return num_regions;
+}
+
+/**
+ * Fills in a snapshot header for the object
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param header A pointer to the header to fill in
+ * @param magic GBC_SNAPSHOT_MAGIC or GBC_SNAPSHOT_DELTA_MAGIC
+ * @param subsystems The parts of the state in the snapshot, see the snapshot flags
+ * @param num_bytes The size of the whole snapshot in bytes
+ */
+static void fill_snapshot_header(GBC_Graphics *self, GBC_Snapshot_Header *header, uint16_t magic, uint8_t subsystems, uint32_t num_bytes) {
+    memset(header, 0, sizeof(GBC_Snapshot_Header));
+    header->magic = magic;
+    header->subsystems = subsystems;
+    header->num_backgrounds = self->num_backgrounds;
+    memcpy(header->map_sizes, self->bg_map_sizes, self->num_backgrounds);
+    header->num_vram_banks = self->num_vram_banks;
+    header->num_sprites = self->num_sprites;
+    header->num_bytes = num_bytes;
+}
+
+/**
+ * Checks that a full snapshot was taken from an object laid out like this one
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param snapshot A pointer to the snapshot
+ * 
+ * @return true if the snapshot can be restored into the object
+ */
+static bool snapshot_matches(GBC_Graphics *self, const uint8_t *snapshot) {
+    if (snapshot == NULL) return false;
+    const GBC_Snapshot_Header *header = (const GBC_Snapshot_Header*)snapshot;
+    GBC_Snapshot_Header expected;
+    fill_snapshot_header(self, &expected, GBC_SNAPSHOT_MAGIC, header->subsystems & GBC_SNAPSHOT_ALL, 
+                         GBC_Graphics_snapshot_get_size(self, header->subsystems));
+    return memcmp(header, &expected, sizeof(GBC_Snapshot_Header)) == 0;
+}
+
+/**
+ * Rebuilds everything that's derived from the state a snapshot restored
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param subsystems The parts of the state that were restored, see the snapshot flags
+ */
+static void finish_snapshot_restore(GBC_Graphics *self, uint8_t subsystems) {
+    if (subsystems & GBC_SNAPSHOT_OAM_FLAG) {
+        GBC_Graphics_oam_sync(self); // Decode and bin the restored sprites
+    }
+    if (subsystems & GBC_SNAPSHOT_PALETTES_FLAG) {
+        mark_palettes_dirty(self, 0xFFFF);
+    }
+    if (subsystems & GBC_SNAPSHOT_VRAM_FLAG) {
+        update_tile_masks(self, 0, self->num_vram_banks << 8);
+    }
+    invalidate_bg_caches(self, GBC_BG_CACHE_ALL);
+}
+
+/**
+ * Writes a 16 bit value to a delta snapshot, which can be unaligned
+ * 
+ * @param bytes A pointer to where the value will be stored
+ * @param value The value
+ */
+static void write_delta_value(uint8_t *bytes, uint16_t value) {
+    memcpy(bytes, &value, sizeof(uint16_t));
+}
+
+/**
+ * Reads a 16 bit value from a delta snapshot, which can be unaligned
+ * 
+ * @param bytes A pointer to the value
+ * 
+ * @return The value
+ */
+static uint16_t read_delta_value(const uint8_t *bytes) {
+    uint16_t value;
+    memcpy(&value, bytes, sizeof(uint16_t));
+    return value;
+}
+
+size_t GBC_Graphics_snapshot_get_size(GBC_Graphics *self, uint8_t subsystems) {
+    GBC_Snapshot_Region regions[GBC_SNAPSHOT_MAX_REGIONS];
+    uint8_t num_regions = get_snapshot_regions(self, subsystems, regions);
+    size_t num_bytes = sizeof(GBC_Snapshot_Header);
+    for (uint8_t region = 0; region < num_regions; region++) {
+        num_bytes += regions[region].num_bytes;
+    }
+    return num_bytes;
+}
+
+size_t GBC_Graphics_snapshot_save(GBC_Graphics *self, uint8_t subsystems, uint8_t *buffer, size_t buffer_size) {
+    subsystems &= GBC_SNAPSHOT_ALL;
+    size_t num_bytes = GBC_Graphics_snapshot_get_size(self, subsystems);
+    if (buffer == NULL || num_bytes > buffer_size) return 0;
+
+    // The header, then each block of state one after another
+    fill_snapshot_header(self, (GBC_Snapshot_Header*)buffer, GBC_SNAPSHOT_MAGIC, subsystems, num_bytes);
+    GBC_Snapshot_Region regions[GBC_SNAPSHOT_MAX_REGIONS];
+    uint8_t num_regions = get_snapshot_regions(self, subsystems, regions);
+    uint8_t *payload = buffer + sizeof(GBC_Snapshot_Header);
+    for (uint8_t region = 0; region < num_regions; region++) {
+        memcpy(payload, regions[region].data, regions[region].num_bytes);
+        payload += regions[region].num_bytes;
+    }
+    return num_bytes;
+}
+
+bool GBC_Graphics_snapshot_restore(GBC_Graphics *self, const uint8_t *snapshot) {
+    if (!snapshot_matches(self, snapshot)) return false;
+
+    uint8_t subsystems = ((const GBC_Snapshot_Header*)snapshot)->subsystems;
+    GBC_Snapshot_Region regions[GBC_SNAPSHOT_MAX_REGIONS];
+    uint8_t num_regions = get_snapshot_regions(self, subsystems, regions);
+    const uint8_t *payload = snapshot + sizeof(GBC_Snapshot_Header);
+    for (uint8_t region = 0; region < num_regions; region++) {
+        memcpy(regions[region].data, payload, regions[region].num_bytes);
+        payload += regions[region].num_bytes;
+    }
+    finish_snapshot_restore(self, subsystems);
+    return true;
+}
+
+size_t GBC_Graphics_snapshot_save_delta(GBC_Graphics *self, const uint8_t *base, uint8_t *buffer, size_t buffer_size) {
+    if (!snapshot_matches(self, base) || buffer == NULL || buffer_size < sizeof(GBC_Snapshot_Header)) return 0;
+
+    uint8_t subsystems = ((const GBC_Snapshot_Header*)base)->subsystems;
+    GBC_Snapshot_Region regions[GBC_SNAPSHOT_MAX_REGIONS];
+    uint8_t num_regions = get_snapshot_regions(self, subsystems, regions);
+    const uint8_t *base_payload = base + sizeof(GBC_Snapshot_Header);
+
+    // The changes are stored as runs: 2 bytes of unchanged bytes to skip, 2 bytes of run length, then the run
+    uint8_t *delta = buffer + sizeof(GBC_Snapshot_Header);
+    uint8_t *delta_end = buffer + buffer_size;
+    uint8_t *run = NULL; // The run being added to, NULL before the first change
+    uint32_t run_end = 0; // The payload offset after the last byte of the run
+    uint16_t run_length = 0;
+    uint32_t offset = 0;
+    for (uint8_t region = 0; region < num_regions; region++) {
+        uint8_t *data = (uint8_t*)regions[region].data;
+        for (uint16_t i = 0; i < regions[region].num_bytes; i++, offset++) {
+            if (data[i] == base_payload[offset]) continue;
+
+            uint32_t gap = offset - run_end;
+            if (run != NULL && gap <= GBC_SNAPSHOT_DELTA_GAP && run_length + gap < UINT16_MAX) {
+                // Close enough to join the run, so the unchanged bytes in between come along
+                if (delta + gap + 1 > delta_end) return 0;
+                memcpy(delta, &base_payload[run_end], gap);
+                delta += gap;
+                run_length += gap;
+            } else {
+                if (run != NULL) write_delta_value(run + 2, run_length);
+                while (gap > UINT16_MAX) {
+                    // Skips too long for one run get empty runs
+                    if (delta + 4 > delta_end) return 0;
+                    write_delta_value(delta, UINT16_MAX);
+                    write_delta_value(delta + 2, 0);
+                    delta += 4;
+                    gap -= UINT16_MAX;
+                }
+                if (delta + 5 > delta_end) return 0;
+                run = delta;
+                write_delta_value(run, gap);
+                delta += 4;
+                run_length = 0;
+            }
+            *delta++ = data[i];
+            run_length++;
+            run_end = offset + 1;
+        }
+    }
+    if (run != NULL) write_delta_value(run + 2, run_length);
+
+    size_t num_bytes = delta - buffer;
+    fill_snapshot_header(self, (GBC_Snapshot_Header*)buffer, GBC_SNAPSHOT_DELTA_MAGIC, subsystems, num_bytes);
+    return num_bytes;
+}
+
+bool GBC_Graphics_snapshot_restore_delta(GBC_Graphics *self, const uint8_t *base, const uint8_t *delta) {
+    if (!snapshot_matches(self, base) || delta == NULL) return false;
+    const GBC_Snapshot_Header *base_header = (const GBC_Snapshot_Header*)base;
+    const GBC_Snapshot_Header *delta_header = (const GBC_Snapshot_Header*)delta;
+    GBC_Snapshot_Header expected;
+    fill_snapshot_header(self, &expected, GBC_SNAPSHOT_DELTA_MAGIC, base_header->subsystems, delta_header->num_bytes);
+    if (memcmp(delta_header, &expected, sizeof(GBC_Snapshot_Header)) != 0) return false;
+
+    // Check every run lands in the snapshot before changing anything
+    uint32_t payload_size = base_header->num_bytes - sizeof(GBC_Snapshot_Header);
+    const uint8_t *delta_end = delta + delta_header->num_bytes;
+    const uint8_t *run;
+    uint32_t offset = 0;
+    for (run = delta + sizeof(GBC_Snapshot_Header); run + 4 <= delta_end; run += 4 + read_delta_value(run + 2)) {
+        offset += read_delta_value(run) + read_delta_value(run + 2);
+        if (offset > payload_size || run + 4 + read_delta_value(run + 2) > delta_end) return false;
+    }
+    if (run != delta_end) return false;
+
+    // Restore the base, then copy each run over the blocks of state it covers
+    GBC_Snapshot_Region regions[GBC_SNAPSHOT_MAX_REGIONS];
+    get_snapshot_regions(self, base_header->subsystems, regions);
+    GBC_Graphics_snapshot_restore(self, base);
+    uint8_t region = 0;
+    uint32_t region_start = 0; // The payload offset of the start of the region
+    offset = 0;
+    for (run = delta + sizeof(GBC_Snapshot_Header); run < delta_end; run += 4 + read_delta_value(run + 2)) {
+        offset += read_delta_value(run);
+        const uint8_t *bytes = run + 4;
+        uint16_t run_length = read_delta_value(run + 2);
+        while (run_length > 0) {
+            while (offset >= region_start + regions[region].num_bytes) {
+                region_start += regions[region].num_bytes;
+                region++;
+            }
+            uint16_t num_bytes = GBC_MIN(run_length, region_start + regions[region].num_bytes - offset);
+            memcpy((uint8_t*)regions[region].data + (offset - region_start), bytes, num_bytes);
+            bytes += num_bytes;
+            offset += num_bytes;
+            run_length -= num_bytes;
+        }
+    }
+    finish_snapshot_restore(self, base_header->subsystems);
+    return true;
+}
+
+int GBC_Graphics_snapshot_persist(const uint8_t *snapshot, uint32_t first_key) {
+    uint32_t num_bytes = ((const GBC_Snapshot_Header*)snapshot)->num_bytes;
+    int num_keys = 0;
+    for (uint32_t written = 0; written < num_bytes; written += PERSIST_DATA_MAX_LENGTH) {
+        int status = persist_write_data(first_key + num_keys, snapshot + written, GBC_MIN(num_bytes - written, PERSIST_DATA_MAX_LENGTH));
+        if (status < 0) return status;
+        num_keys++;
+    }
+    return num_keys;
+}
+
+size_t GBC_Graphics_snapshot_load_persisted(uint32_t first_key, uint8_t *buffer, size_t buffer_size) {
+    if (buffer == NULL || buffer_size < sizeof(GBC_Snapshot_Header) || !persist_exists(first_key)) return 0;
+
+    // The first key holds the header, which says how many more keys to read
+    if (persist_read_data(first_key, buffer, GBC_MIN(buffer_size, PERSIST_DATA_MAX_LENGTH)) < (int)sizeof(GBC_Snapshot_Header)) return 0;
+    const GBC_Snapshot_Header *header = (const GBC_Snapshot_Header*)buffer;
+    if (header->magic != GBC_SNAPSHOT_MAGIC && header->magic != GBC_SNAPSHOT_DELTA_MAGIC) return 0;
+    uint32_t num_bytes = header->num_bytes;
+    if (num_bytes > buffer_size) return 0;
+    uint32_t key = first_key + 1;
+    for (uint32_t read = PERSIST_DATA_MAX_LENGTH; read < num_bytes; read += PERSIST_DATA_MAX_LENGTH) {
+        if (persist_read_data(key++, buffer + read, GBC_MIN(num_bytes - read, PERSIST_DATA_MAX_LENGTH)) < 0) return 0;
+    }
+    return num_bytes;
+}
+
+/**
+ * Allocates the tile collision flags table if it hasn't been yet, with every tile starting with no flags
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * 
+ * @return true if the table is allocated
+ */
+static bool allocate_tile_collision_flags(GBC_Graphics *self) {
+    if (self->tile_collision_flags == NULL) {
+        self->tile_collision_flags = (uint8_t*)calloc(self->num_vram_banks << 8, 1); // One byte per tile in VRAM
+    }
+    return self->tile_collision_flags != NULL;
+}
+
+void GBC_Graphics_collision_set_tile_flags(GBC_Graphics *self, uint16_t tile_number, uint8_t flags) {
+    GBC_Graphics_collision_set_tile_flags_array(self, tile_number, &flags, 1);
+}
+
+void GBC_Graphics_collision_set_tile_flags_array(GBC_Graphics *self, uint16_t first_tile_number, const uint8_t *flags_array, uint16_t num_tiles) {
+    uint16_t num_vram_tiles = self->num_vram_banks << 8;
+    if (first_tile_number >= num_vram_tiles || !allocate_tile_collision_flags(self)) return;
+    memcpy(&self->tile_collision_flags[first_tile_number], flags_array, GBC_MIN(num_tiles, num_vram_tiles - first_tile_number));
+}
+
+uint8_t GBC_Graphics_collision_get_tile_flags(GBC_Graphics *self, uint16_t tile_number) {
+    if (self->tile_collision_flags == NULL || tile_number >= (self->num_vram_banks << 8)) return 0;
+    return self->tile_collision_flags[tile_number];
+}
+
+uint8_t GBC_Graphics_collision_get_map_flags(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y) {
+    if (*get_map_attr(self, bg_layer, x, y) & GBC_ATTR_HIDE_FLAG) return 0;
+    return GBC_Graphics_collision_get_tile_flags(self, GBC_Graphics_bg_get_wide_tile(self, bg_layer, x, y));
+}
+
+uint8_t GBC_Graphics_collision_check_rect(GBC_Graphics *self, uint8_t bg_layer, GRect rect) {
+    if (self->tile_collision_flags == NULL || rect.size.w <= 0 || rect.size.h <= 0) return 0;
+    uint8_t map_width = GBC_Graphics_bg_get_map_width(self, bg_layer);
+    uint8_t map_height = GBC_Graphics_bg_get_map_height(self, bg_layer);
+
+    // Find the tiles under the corners, keeping the rows and columns that wrap around the map to no more than the map's size
+    int16_t left = rect.origin.x + self->bg_scroll_x[bg_layer];
+    int16_t top = rect.origin.y + self->bg_scroll_y[bg_layer];
+    int16_t first_x = left >> 3, first_y = top >> 3; // Shift to round down, even when they're negative
+    uint16_t num_columns = GBC_MIN(((left + rect.size.w - 1) >> 3) - first_x + 1, map_width);
+    uint16_t num_rows = GBC_MIN(((top + rect.size.h - 1) >> 3) - first_y + 1, map_height);
+
+    uint8_t flags = 0;
+    for (uint16_t row = 0; row < num_rows; row++) {
+        for (uint16_t column = 0; column < num_columns; column++) {
+            flags |= GBC_Graphics_collision_get_map_flags(self, bg_layer, (first_x + column) & (map_width - 1), (first_y + row) & (map_height - 1));
+        }
+    }
+    return flags;
+}
+
+bool GBC_Graphics_collision_cast_ray(GBC_Graphics *self, uint8_t bg_layer, GPoint from, GPoint to, uint8_t flags, GPoint *hit) {
+    if (self->tile_collision_flags == NULL) return false;
+    uint8_t map_width = GBC_Graphics_bg_get_map_width(self, bg_layer);
+    uint8_t map_height = GBC_Graphics_bg_get_map_height(self, bg_layer);
+    short scroll_x = self->bg_scroll_x[bg_layer], scroll_y = self->bg_scroll_y[bg_layer];
+
+    // Step along the line a pixel at a time, but only look a tile up when the line moves onto a new one
+    int16_t dx = abs(to.x - from.x), dy = -abs(to.y - from.y);
+    int8_t step_x = from.x < to.x ? 1 : -1, step_y = from.y < to.y ? 1 : -1;
+    int16_t error = dx + dy;
+    int16_t x = from.x, y = from.y;
+    int16_t tile_x = 0, tile_y = 0;
+    bool first_pixel = true;
+    while (true) {
+        int16_t pixel_tile_x = (x + scroll_x) >> 3, pixel_tile_y = (y + scroll_y) >> 3;
+        if (first_pixel || pixel_tile_x != tile_x || pixel_tile_y != tile_y) {
+            tile_x = pixel_tile_x;
+            tile_y = pixel_tile_y;
+            first_pixel = false;
+            if (GBC_Graphics_collision_get_map_flags(self, bg_layer, tile_x & (map_width - 1), tile_y & (map_height - 1)) & flags) {
+                if (hit != NULL) {
+                    *hit = GPoint(x, y);
+                }
+                return true;
+            }
+        }
+        if (x == to.x && y == to.y) return false;
+        int16_t double_error = 2 * error; // Both steps are decided from the error before either is taken
+        if (double_error >= dy) {
+            error += dy;
+            x += step_x;
+        }
+        if (double_error <= dx) {
+            error += dx;
+            y += step_y;
+        }
+    }
+}
+
+/**
+ * Moves a sprite down a heap of sprites ordered by their left edge, until neither of its children is further right
+ * 
+ * @param x The decoded x positions of the sprites
+ * @param heap The sprite numbers in the heap
+ * @param root The index of the sprite to move down
+ * @param heap_size The number of sprites in the heap
+ */
+static void sift_sprite_down(short *x, uint16_t *heap, uint16_t root, uint16_t heap_size) {
+    uint16_t sprite_num = heap[root];
+    uint16_t child;
+    while ((child = (root << 1) + 1) < heap_size) {
+        if (child + 1 < heap_size && x[heap[child + 1]] > x[heap[child]]) {
+            child++;
+        }
+        if (x[heap[child]] <= x[sprite_num]) break;
+        heap[root] = heap[child];
+        root = child;
+    }
+    heap[root] = sprite_num;
+}
+
+/**
+ * Sorts sprites by their left edge in place, with a heap sort so it stays O(n log n) however the sprites are placed
+ * 
+ * @param x The decoded x positions of the sprites
+ * @param sprites The sprite numbers to sort
+ * @param num_sprites The number of sprites to sort
+ */
+static void sort_sprites_by_x(short *x, uint16_t *sprites, uint16_t num_sprites) {
+    for (uint16_t i = num_sprites >> 1; i > 0; i--) {
+        sift_sprite_down(x, sprites, i - 1, num_sprites);
+    }
+    for (uint16_t end = num_sprites; end > 1; end--) {
+        // Swap the furthest right sprite into its place at the end, then restore the heap before it
+        uint16_t sprite_num = sprites[0];
+        sprites[0] = sprites[end - 1];
+        sprites[end - 1] = sprite_num;
+        sift_sprite_down(x, sprites, 0, end - 1);
+    }
+}
+
+uint16_t GBC_Graphics_collision_find_sprite_pairs(GBC_Graphics *self, uint16_t *pairs, uint16_t max_pairs) {
+    GBC_Sprite_Cache *cache = &self->sprite_cache;
+    uint16_t *sorted = self->line_sprites;
+    uint16_t num_sorted = 0;
+
+    // Gather the visible sprites, then sort them by their left edge
+    for (uint16_t sprite_num = 0; sprite_num < self->num_sprites; sprite_num++) {
+        short x = cache->x[sprite_num], y = cache->y[sprite_num];
+        bool on_screen = (cache->attrs[sprite_num] & GBC_ATTR_HIDE_FLAG) == 0
+                         && x < self->screen_width && x + (cache->width[sprite_num] << cache->size_shift[sprite_num]) > 0
+                         && y < self->screen_height && y + (cache->height[sprite_num] << cache->size_shift[sprite_num]) > 0;
+        if (on_screen) {
+            sorted[num_sorted++] = sprite_num;
+        }
+    }
+    sort_sprites_by_x(cache->x, sorted, num_sorted);
+
+    // Sweep across, checking each sprite against the ones that start before it ends
+    uint16_t num_pairs = 0;
+    for (uint16_t i = 0; i < num_sorted; i++) {
+        uint16_t sprite_1 = sorted[i];
+        short right = cache->x[sprite_1] + (cache->width[sprite_1] << cache->size_shift[sprite_1]);
+        short top = cache->y[sprite_1];
+        short bottom = top + (cache->height[sprite_1] << cache->size_shift[sprite_1]);
+        for (uint16_t j = i + 1; j < num_sorted && cache->x[sorted[j]] < right; j++) {
+            uint16_t sprite_2 = sorted[j];
+            if (cache->y[sprite_2] >= bottom || cache->y[sprite_2] + (cache->height[sprite_2] << cache->size_shift[sprite_2]) <= top) continue;
+            if (num_pairs == max_pairs) return num_pairs;
+            pairs[num_pairs * 2] = GBC_MIN(sprite_1, sprite_2);
+            pairs[num_pairs * 2 + 1] = GBC_MAX(sprite_1, sprite_2);
+            num_pairs++;
+        }
+    }
+    return num_pairs;
+}
+
+/**
+ * Reverses the bits of a byte, to flip a row of a tile mask
+ * 
+ * @param byte The byte to reverse
+ * 
+ * @return The reversed byte
+ */
+static uint8_t reverse_byte(uint8_t byte) {
+    byte = (byte & 0xF0) >> 4 | (byte & 0x0F) << 4;
+    byte = (byte & 0xCC) >> 2 | (byte & 0x33) << 2;
+    return (byte & 0xAA) >> 1 | (byte & 0x55) << 1;
+}
+
+/**
+ * Rebuilds the occupancy masks of a run of tiles from VRAM, if the masks are enabled
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param first_tile_number The number of the first tile, vram_bank * 256 + tile_position
+ * @param num_tiles The number of tiles to rebuild
+ */
+static void update_tile_masks(GBC_Graphics *self, uint16_t first_tile_number, uint16_t num_tiles) {
+    uint16_t num_vram_tiles = self->num_vram_banks << 8;
+    if (self->tile_masks == NULL || first_tile_number >= num_vram_tiles) return;
+    num_tiles = GBC_MIN(num_tiles, num_vram_tiles - first_tile_number);
+
+    uint8_t *tile = self->vram + (first_tile_number << 5); // self->vram + first_tile_number * GBC_TILE_NUM_BYTES
+    uint8_t *mask = self->tile_masks + (first_tile_number << 3); // 8 rows per tile
+    for (uint16_t i = 0; i < num_tiles * GBC_TILE_HEIGHT; i++) {
+        // Each row is 4 bytes of 2 pixels, left pixel in the high nibble, and any non-zero pixel is solid
+        uint8_t row = 0;
+        for (uint8_t byte = 0; byte < 4; byte++) {
+            row |= (((tile[byte] & 0xF0) != 0) << (7 - (byte << 1))) | (((tile[byte] & 0x0F) != 0) << (6 - (byte << 1)));
+        }
+        mask[i] = row;
+        tile += 4;
+    }
+}
+
+/**
+ * Gets a row of a tile's occupancy mask, leftmost pixel in the highest bit
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param tile_number The tile's number, vram_bank * 256 + tile_position
+ * @param row The row of the tile, from 0 to 7
+ * 
+ * @return The row's mask, every pixel when the masks are disabled, and none for tiles past the end of VRAM
+ */
+static uint8_t get_tile_mask_row(GBC_Graphics *self, uint16_t tile_number, uint8_t row) {
+    if (tile_number >= (self->num_vram_banks << 8)) return 0x00;
+    if (self->tile_masks == NULL) return 0xFF;
+    return self->tile_masks[(tile_number << 3) + row];
+}
+
+/**
+ * Gets 32 columns of a row of a sprite's occupancy mask as it's drawn, with its flips applied
+ * Affine sprites are treated as solid across their bounding box
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param y The row on the screen, within the sprite's bounding box
+ * @param x The column on the screen of the mask's highest bit, at or past the sprite's left edge, any distance into it
+ * 
+ * @return The mask, with a bit for each solid pixel from x onwards
+ */
+static uint32_t get_sprite_mask_row(GBC_Graphics *self, uint16_t sprite_num, short y, short x) {
+    GBC_Sprite_Cache *cache = &self->sprite_cache;
+    uint8_t width = cache->width[sprite_num], height = cache->height[sprite_num];
+    short column = x - cache->x[sprite_num];
+    if (cache->affine_matrix[sprite_num] != GBC_SPRITE_NOT_AFFINE) {
+        short box_columns_left = (width << cache->size_shift[sprite_num]) - column;
+        if (box_columns_left <= 0) return 0x00000000;
+        return box_columns_left >= 32 ? 0xFFFFFFFF : ~(0xFFFFFFFF >> box_columns_left); // The rest of the box
+    }
+
+    // Line up the (up to 5) tiles drawn under the 32 columns, the tiles of a sprite follow each other in VRAM
+    uint8_t row = y - cache->y[sprite_num];
+    row = (cache->attrs[sprite_num] & GBC_ATTR_FLIP_FLAG_Y) ? height - 1 - row : row;
+    short tiles_per_row = width >> 3;
+    uint16_t tile_number = ((cache->tiles[sprite_num] - self->vram) >> 5) + (row >> 3) * tiles_per_row;
+    short first_tile_x = column >> 3;
+    uint64_t mask = 0;
+    for (short tile_x = first_tile_x; tile_x < tiles_per_row && tile_x < first_tile_x + 5; tile_x++) {
+        uint8_t tile_mask;
+        if (cache->attrs[sprite_num] & GBC_ATTR_FLIP_FLAG_X) {
+            // Flipped sprites draw their tiles from right to left, each one mirrored
+            tile_mask = reverse_byte(get_tile_mask_row(self, tile_number + tiles_per_row - 1 - tile_x, row & 7));
+        } else {
+            tile_mask = get_tile_mask_row(self, tile_number + tile_x, row & 7);
+        }
+        mask |= (uint64_t)tile_mask << (56 - ((tile_x - first_tile_x) << 3));
+    }
+    return (mask << (column & 7)) >> 32;
+}
+
+void GBC_Graphics_collision_set_tile_masks_enabled(GBC_Graphics *self, bool enabled) {
+    free(self->tile_masks);
+    self->tile_masks = enabled ? (uint8_t*)malloc(self->num_vram_banks << 11) : NULL; // 8 bytes per tile in VRAM
+    update_tile_masks(self, 0, self->num_vram_banks << 8);
+}
+
+void GBC_Graphics_collision_update_tile_masks(GBC_Graphics *self, uint16_t first_tile_number, uint16_t num_tiles) {
+    update_tile_masks(self, first_tile_number, num_tiles);
+}
+
+bool GBC_Graphics_collision_check_sprites(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2) {
+    GBC_Sprite_Cache *cache = &self->sprite_cache;
+    if ((cache->attrs[sprite_num_1] | cache->attrs[sprite_num_2]) & GBC_ATTR_HIDE_FLAG) return false;
+
+    // Find where the bounding boxes overlap
+    short left = GBC_MAX(cache->x[sprite_num_1], cache->x[sprite_num_2]);
+    short right = GBC_MIN(cache->x[sprite_num_1] + (cache->width[sprite_num_1] << cache->size_shift[sprite_num_1]), 
+                          cache->x[sprite_num_2] + (cache->width[sprite_num_2] << cache->size_shift[sprite_num_2]));
+    short top = GBC_MAX(cache->y[sprite_num_1], cache->y[sprite_num_2]);
+    short bottom = GBC_MIN(cache->y[sprite_num_1] + (cache->height[sprite_num_1] << cache->size_shift[sprite_num_1]), 
+                           cache->y[sprite_num_2] + (cache->height[sprite_num_2] << cache->size_shift[sprite_num_2]));
+    if (left >= right || top >= bottom) return false;
+    if (self->tile_masks == NULL) return true; // Without masks, the bounding boxes are all there is to check
+
+    // The masks are built 32 columns at a time, so step across the overlap in windows that wide
+    for (short x = left; x < right; x += 32) {
+        for (short y = top; y < bottom; y++) {
+            if (get_sprite_mask_row(self, sprite_num_1, y, x) & get_sprite_mask_row(self, sprite_num_2, y, x)) return true;
+        }
+    }
+    return false;
+}
+
+uint8_t GBC_Graphics_collision_check_sprite_bg(GBC_Graphics *self, uint16_t sprite_num, uint8_t bg_layer, uint8_t flags) {
+    GBC_Sprite_Cache *cache = &self->sprite_cache;
+    if (self->tile_collision_flags == NULL || (cache->attrs[sprite_num] & GBC_ATTR_HIDE_FLAG)) return 0;
+    uint8_t map_width = GBC_Graphics_bg_get_map_width(self, bg_layer);
+    uint8_t map_height = GBC_Graphics_bg_get_map_height(self, bg_layer);
+    short box_width = cache->width[sprite_num] << cache->size_shift[sprite_num];
+    short box_height = cache->height[sprite_num] << cache->size_shift[sprite_num];
+
+    uint8_t hit_flags = 0;
+    for (short x = cache->x[sprite_num]; x < cache->x[sprite_num] + box_width; x += 32) {
+        for (short y = cache->y[sprite_num]; y < cache->y[sprite_num] + box_height; y++) {
+            uint32_t sprite_mask = get_sprite_mask_row(self, sprite_num, y, x);
+            if (sprite_mask == 0) continue;
+
+            // Line the 5 tiles under these 32 columns up with the sprite's mask, and check each one that has the flags
+            int16_t map_x = x + self->bg_scroll_x[bg_layer], map_y = y + self->bg_scroll_y[bg_layer];
+            uint8_t tile_y = (map_y >> 3) & (map_height - 1);
+            for (uint8_t tile = 0; tile < 5; tile++) {
+                uint8_t tile_x = ((map_x >> 3) + tile) & (map_width - 1);
+                uint8_t tile_flags = GBC_Graphics_collision_get_map_flags(self, bg_layer, tile_x, tile_y) & flags & ~hit_flags;
+                if (tile_flags == 0) continue;
+                uint8_t tile_attr = *get_map_attr(self, bg_layer, tile_x, tile_y);
+                uint8_t row = (tile_attr & GBC_ATTR_FLIP_FLAG_Y) ? 7 - (map_y & 7) : (map_y & 7);
+                uint8_t tile_mask = get_tile_mask_row(self, GBC_Graphics_bg_get_wide_tile(self, bg_layer, tile_x, tile_y), row);
+                tile_mask = (tile_attr & GBC_ATTR_FLIP_FLAG_X) ? reverse_byte(tile_mask) : tile_mask;
+                uint32_t bg_mask = ((uint64_t)tile_mask << (56 - (tile << 3)) << (map_x & 7)) >> 32;
+                hit_flags |= tile_flags & BOOL_MASK[(bg_mask & sprite_mask) != 0];
+            }
+            if (hit_flags == flags) return hit_flags; // Nothing left to find
+        }
+    }
+    return hit_flags;
+}
+
+/**
+ * Finds where a metasprite's part goes relative to the metasprite's origin, mirrored around the origin when the metasprite is flipped
+ * 
+ * @param part A pointer to the part
+ * @param attributes The metasprite's attributes
+ * @param part_x A pointer to where the x offset of the part's left edge will be stored
+ * @param part_y A pointer to where the y offset of the part's top edge will be stored
+ */
+static void get_metasprite_part_offset(const GBC_Metasprite_Part *part, uint8_t attributes, short *part_x, short *part_y) {
+    // Flipping mirrors the part around the origin, so its far edge ends up where its near edge was
+    *part_x = (attributes & GBC_ATTR_FLIP_FLAG_X) ? -part->x - ((1 + (part->width & GBC_SPRITE_MAX_WIDTH)) << 3) : part->x;
+    *part_y = (attributes & GBC_ATTR_FLIP_FLAG_Y) ? -part->y - ((1 + (part->height & GBC_SPRITE_MAX_HEIGHT)) << 3) : part->y;
+}
+
+void GBC_Graphics_metasprite_set(GBC_Graphics *self, uint16_t sprite_num, uint8_t num_sprites, const GBC_Metasprite *metasprite, short x, short y, uint8_t tile_position, uint8_t attributes) {
+    if (sprite_num >= self->num_sprites) return;
+    num_sprites = GBC_MIN(num_sprites, self->num_sprites - sprite_num);
+    uint8_t num_parts = GBC_MIN(metasprite->num_parts, num_sprites);
+    short part_x, part_y;
+
+    // Clamp the origin rather than each part, so the parts keep their layout at the edges of the sprite positions
+    short min_part_x = 0, max_part_x = 0, min_part_y = 0, max_part_y = 0;
+    for (uint8_t part_num = 0; part_num < num_parts; part_num++) {
+        get_metasprite_part_offset(&metasprite->parts[part_num], attributes, &part_x, &part_y);
+        min_part_x = part_num == 0 ? part_x : GBC_MIN(min_part_x, part_x);
+        max_part_x = part_num == 0 ? part_x : GBC_MAX(max_part_x, part_x);
+        min_part_y = part_num == 0 ? part_y : GBC_MIN(min_part_y, part_y);
+        max_part_y = part_num == 0 ? part_y : GBC_MAX(max_part_y, part_y);
+    }
+    x = GBC_MAX(GBC_MIN(x, GBC_SPRITE_MAX_X - max_part_x), -min_part_x);
+    y = GBC_MAX(GBC_MIN(y, GBC_SPRITE_MAX_Y - max_part_y), -min_part_y);
+
+    for (uint8_t part_num = 0; part_num < num_parts; part_num++) {
+        const GBC_Metasprite_Part *part = &metasprite->parts[part_num];
+        get_metasprite_part_offset(part, attributes, &part_x, &part_y);
+
+        // The flips combine, the palette and VRAM bank numbers add up, and a hidden part stays hidden while hiding the metasprite hides every part
+        uint8_t part_attrs = ((part->attrs ^ attributes) & (GBC_ATTR_FLIP_FLAG_X | GBC_ATTR_FLIP_FLAG_Y)) |
+                             ((part->attrs + attributes) & GBC_ATTR_PALETTE_MASK) |
+                             (((part->attrs & GBC_ATTR_VRAM_BANK_MASK) + (attributes & GBC_ATTR_VRAM_BANK_MASK)) & GBC_ATTR_VRAM_BANK_MASK) |
+                             ((part->attrs | attributes) & GBC_ATTR_HIDE_FLAG);
+        GBC_Graphics_oam_set_sprite(self, sprite_num + part_num, x + part_x, y + part_y, tile_position + part->tile_offset, part_attrs, part->width, part->height, 0, 0);
+    }
+
+    // Hide the leftover sprites at the origin, in case the last frame had more parts, so they move along with the rest
+    for (uint8_t part_num = num_parts; part_num < num_sprites; part_num++) {
+        GBC_Graphics_oam_set_sprite_hidden(self, sprite_num + part_num, true);
+        GBC_Graphics_oam_set_sprite_pos(self, sprite_num + part_num, x, y);
+    }
+}
+
+void GBC_Graphics_metasprite_move(GBC_Graphics *self, uint16_t sprite_num, uint8_t num_sprites, short dx, short dy) {
+    if (sprite_num >= self->num_sprites) return;
+    num_sprites = GBC_MIN(num_sprites, self->num_sprites - sprite_num);
+    if (num_sprites == 0) return;
+
+    // Limit the move so no sprite gets clamped on its own, which would pull the parts out of their layout
+    short min_x = GBC_SPRITE_MAX_X, max_x = 0, min_y = GBC_SPRITE_MAX_Y, max_y = 0;
+    for (uint8_t part_num = 0; part_num < num_sprites; part_num++) {
+        min_x = GBC_MIN(min_x, (short)GBC_Graphics_oam_get_sprite_x(self, sprite_num + part_num));
+        max_x = GBC_MAX(max_x, (short)GBC_Graphics_oam_get_sprite_x(self, sprite_num + part_num));
+        min_y = GBC_MIN(min_y, (short)GBC_Graphics_oam_get_sprite_y(self, sprite_num + part_num));
+        max_y = GBC_MAX(max_y, (short)GBC_Graphics_oam_get_sprite_y(self, sprite_num + part_num));
+    }
+    dx = GBC_MAX(GBC_MIN(dx, GBC_SPRITE_MAX_X - max_x), -min_x);
+    dy = GBC_MAX(GBC_MIN(dy, GBC_SPRITE_MAX_Y - max_y), -min_y);
+
+    for (uint8_t part_num = 0; part_num < num_sprites; part_num++) {
+        GBC_Graphics_oam_move_sprite(self, sprite_num + part_num, dx, dy);
+    }
 }
\ No newline at end of file
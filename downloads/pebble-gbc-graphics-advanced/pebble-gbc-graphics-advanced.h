@@ -1,13 +1,14 @@
 #pragma once         ///> Prevent errors by being included multiple times
 
 #include <pebble.h>  ///> Pebble SDK symbols
+#include "pebble-gbc-graphics-advanced-config.h" ///> Build time options
 
 /**
  * This is a graphics engine that renders Game Boy Color style graphics
  * on the Pebble smartwatch, with some Game Boy Advance style modifications
  * @file pebble-gbc-graphics-advanced.h
  * @author Harrison Allen
- * @version 1.5.1 3/23/2025
+ * @version 1.6.0 10/19/2026
  * 
  * Questions? Feel free to send me an email at harrisonallen555@gmail.com
  */
@@ -39,6 +40,24 @@
  * 1 byte per attribute * 32 tiles wide * 32 tiles tall = 1024 bytes
  */
 #define GBC_ATTRMAP_NUM_BYTES 1024
+
+/** Map size definitions, each background's tilemap is a power of two wide and tall */
+#define GBC_MAP_SIZE(width_shift, height_shift) (((width_shift) << 4) | (height_shift)) ///> Makes a map size out of log2 of its width and height in tiles
+#define GBC_MAP_SIZE_WIDTH_MASK 0x70  ///> Mask for log2 of the map width in tiles
+#define GBC_MAP_SIZE_WIDTH_SHIFT 4    ///> The bitshift for start of log2 of the map width
+#define GBC_MAP_SIZE_HEIGHT_MASK 0x0F ///> Mask for log2 of the map height in tiles
+#define GBC_MAP_MIN_SHIFT 4           ///> Maps are at least 16 tiles wide and tall
+#define GBC_MAP_MAX_SHIFT 7           ///> Maps are at most 128 tiles wide and tall
+#define GBC_MAP_MAX_AREA_SHIFT 12     ///> Maps are at most 4096 tiles, the height is reduced to fit
+#define GBC_MAP_SIZE_32X32 GBC_MAP_SIZE(5, 5)  ///> 32 x 32 tiles, the default
+#define GBC_MAP_SIZE_64X32 GBC_MAP_SIZE(6, 5)  ///> 64 x 32 tiles
+#define GBC_MAP_SIZE_32X64 GBC_MAP_SIZE(5, 6)  ///> 32 x 64 tiles
+#define GBC_MAP_SIZE_64X64 GBC_MAP_SIZE(6, 6)  ///> 64 x 64 tiles
+#define GBC_MAP_SIZE_128X16 GBC_MAP_SIZE(7, 4) ///> 128 x 16 tiles
+#define GBC_MAP_SIZE_128X32 GBC_MAP_SIZE(7, 5) ///> 128 x 32 tiles
+#define GBC_MAP_SIZE_32X128 GBC_MAP_SIZE(5, 7) ///> 32 x 128 tiles
+#define GBC_MAP_WIDE_TILES_FLAG 0x80  ///> Flag for a map of 16 bit tile numbers, OR it into the map size, e.g. GBC_MAP_SIZE_64X64 | GBC_MAP_WIDE_TILES_FLAG
+#define GBC_WIDE_TILE_MASK 0x03FF     ///> Mask for a wide tile number, vram_bank * 256 + tile number within the bank
 /**
  * The size of one palette, calculated by:
  * 1 byte per color * 16 colors per palette = 16 bytes
@@ -50,10 +69,11 @@
  * 16 bytes per palette * 8 palettes = 128 bytes
  */
 #define GBC_PALETTE_BANK_NUM_BYTES 128
-#define GBC_NUM_SPRITES 40 ///> The maximum number of sprites
+#define GBC_NUM_PALETTE_ANIMATIONS 8 ///> The number of palette animations that can run at once
+#define GBC_NUM_SPRITES 40 ///> The default number of sprites
 #define GBC_SPRITE_NUM_BYTES 6 ///> The number of bytes per sprite
 /**
- * The size of the OAM, calculated by:
+ * The size of the default OAM, calculated by:
  * 6 bytes per sprite * 40 sprite slots = 240 bytes
  */
 #define GBC_OAM_NUM_BYTES 240
@@ -69,6 +89,16 @@
 #define GBC_SPRITE_MAX_Y 0x01FF ///> The max of a sprite's y position
 #define GBC_SPRITE_MAX_WIDTH 15  ///> The max of a sprite's width
 #define GBC_SPRITE_MAX_HEIGHT 15 ///> The max of a sprite's height
+#define GBC_SPRITE_BIN_SHIFT 3   ///> The bitshift from a line to its sprite bin, 8 lines per bin
+#define GBC_SPRITE_NUM_BINS 32   ///> The number of sprite bins, enough to cover 256 lines
+#define GBC_ARENA_ALIGNMENT sizeof(void*) ///> The alignment of each buffer in the object's arena, and of a buffer passed to GBC_Graphics_ctor_in_buffer
+#define GBC_SPRITE_NUM_AFFINE_MATRICES 16 ///> The number of affine matrices sprites can select from
+#define GBC_SPRITE_NOT_AFFINE 0xFF        ///> The sprite cache affine matrix of a sprite that isn't affine
+#define GBC_AFFINE_MATRIX_NUM_VALUES 4    ///> The number of values per affine matrix
+#define GBC_AFFINE_ONE 0x0100             ///> 1.0 in the 8.8 fixed point format of the affine matrices
+#define GBC_AFFINE_SCALE_MIN 0x0020       ///> The smallest size of an affine rotation scale, 1/8x, either way around
+#define GBC_MAX_NUM_BACKGROUNDS GBC_CONFIG_MAX_BACKGROUNDS ///> The max number of background layers
+#define GBC_BG_NO_PIXEL 0xFF              ///> Returned instead of a pixel where a background isn't drawn
 
 /** Attribute flags */
 #define GBC_ATTR_PALETTE_MASK 0x07      ///> Mask for the palette number
@@ -108,6 +138,65 @@
 #define GBC_ALPHA_MODE_OR 5       ///> Alpha Mode OR - ORs the alpha layer colors with current colors
 #define GBC_ALPHA_MODE_XOR 6      ///> Alpha Mode XOR - XORs the alpha layer colors with current colors
 
+/** Palette animation flags */
+#define GBC_PALETTE_ANIMATION_ENABLE_FLAG 0x01 ///> Flag for a running palette animation
+#define GBC_PALETTE_ANIMATION_SPRITE_FLAG 0x02 ///> Flag for a palette animation of the sprite palettes, rather than the background palettes
+
+/** Dirty palette flags */
+#define GBC_DIRTY_BG_PALETTE_FLAG 0x0001     ///> Flag for a changed background palette 0, shifted left by the palette number for the others
+#define GBC_DIRTY_SPRITE_PALETTE_FLAG 0x0100 ///> Flag for a changed sprite palette 0, shifted left by the palette number for the others
+
+/** Fade flags */
+#define GBC_FADE_BG_FLAG 0x01     ///> Flag for fading the background palettes
+#define GBC_FADE_SPRITE_FLAG 0x02 ///> Flag for fading the sprite palettes
+#define GBC_FADE_MAX 16           ///> The fade amount that fully replaces the palettes with the fade color
+
+/** Dither mode flags */
+#define GBC_DITHER_MODE_MASK 0x03    ///> Mask for BG 1's dither mode, shifted left by 2 * the bg number for the others
+#define GBC_DITHER_MODE_START 0x01   ///> LSB of BG 1's dither mode, shifted left by 2 * the bg number for the others
+#define GBC_DITHER_SPRITE_SHIFT 8    ///> The bitshift for start of the sprite dither mode
+#define GBC_NUM_DITHER_MODES 4       ///> The number of dither modes
+
+/** Dither modes */
+#define GBC_DITHER_CHECKER 0 ///> Checker - Gray is a 2x2 checkerboard, alpha gray is black
+#define GBC_DITHER_BAYER 1   ///> Bayer - Gray and alpha gray use a 4x4 ordered dither, 50% and 25% white
+#define GBC_DITHER_LINES 2   ///> Lines - Gray is every other line, alpha gray every fourth, so horizontal scrolling doesn't shimmer
+#define GBC_DITHER_NONE 3    ///> None - Gray draws as white, alpha gray as black
+
+/** BG Affine flags */
+#define GBC_BG_AFFINE_ENABLE_FLAG 0x01 ///> Flag for BG 1 affine enable bit, shifted left by the bg number for the others
+#define GBC_BG_AFFINE_CLIP_FLAG 0x10   ///> Flag for BG 1 affine clip bit, shifted left by the bg number for the others
+
+/** BG Direct Color flags */
+#define GBC_BG_DIRECT_COLOR_FLAG 0x01     ///> Flag for BG 1 direct color bit, shifted left by the bg number for the others
+#define GBC_DIRECT_COLOR_ALPHA_MASK 0xC0  ///> Direct color pixels with none of these bits set (like GColorClear) are transparent
+#define GBC_DIRECT_COLOR_PIXEL 0x01       ///> The palette pixel number that opaque direct color pixels are drawn as
+
+/** BG Cache flags */
+#define GBC_BG_CACHE_FLAG 0x01 ///> Flag for BG 1 cache bit, shifted left by the bg number for the others
+#define GBC_BG_CACHE_ALL 0x0F  ///> Flags for every background's cache bit
+
+/** Snapshot flags, for the parts of the object's state that a snapshot holds */
+#define GBC_SNAPSHOT_MAPS_FLAG 0x01      ///> Flag for the tilemaps and attrmaps
+#define GBC_SNAPSHOT_PALETTES_FLAG 0x02  ///> Flag for the background and sprite palette banks
+#define GBC_SNAPSHOT_OAM_FLAG 0x04       ///> Flag for OAM and the sprite affine matrices
+#define GBC_SNAPSHOT_REGISTERS_FLAG 0x08 ///> Flag for the scroll, affine, mosaic, LCDC, STAT, fade, alpha and dither registers
+#define GBC_SNAPSHOT_VRAM_FLAG 0x10      ///> Flag for VRAM
+#define GBC_SNAPSHOT_ALL 0x1F            ///> Flags for all of the above
+#define GBC_SNAPSHOT_MAGIC 0x5347        ///> Marks the start of a snapshot, "GS"
+#define GBC_SNAPSHOT_DELTA_MAGIC 0x4447  ///> Marks the start of a delta snapshot, "GD"
+#define GBC_SNAPSHOT_MAX_REGIONS 24      ///> The most blocks of state that a snapshot copies
+#define GBC_SNAPSHOT_DELTA_GAP 4         ///> Delta runs with unchanged gaps up to this long are joined, since a new run costs 4 bytes
+
+/** BG Mosaic flags */
+#define GBC_BG_MOSAIC_WIDTH_MASK 0x0F   ///> Mask for BG mosaic width
+#define GBC_BG_MOSAIC_WIDTH_START 0x01  ///> LSB of the BG mosaic width
+#define GBC_BG_MOSAIC_WIDTH_SHIFT 0     ///> The bitshift for start of BG mosaic width
+#define GBC_BG_MOSAIC_HEIGHT_MASK 0xF0  ///> Mask for BG mosaic height
+#define GBC_BG_MOSAIC_HEIGHT_START 0x10 ///> LSB of the BG mosaic height
+#define GBC_BG_MOSAIC_HEIGHT_SHIFT 4    ///> The bitshift for start of BG mosaic height
+#define GBC_BG_MOSAIC_MAX_SIZE 16       ///> The max width or height of a BG mosaic block
+
 /** STAT flags */
 #define GBC_STAT_HBLANK_FLAG 0x01        ///> Flag for STAT HBlank flag bit
 #define GBC_STAT_VBLANK_FLAG 0X02        ///> Flag for STAT VBlank flag bit
@@ -136,17 +225,23 @@
 #define GBC_OAM_SPRITE_MOSAIC_Y_MASK 0xC0  ///> Mask for OAM sprite mosaic y
 #define GBC_OAM_SPRITE_MOSAIC_Y_START 0x40 ///> LSB of the OAM sprite mosaic y
 #define GBC_OAM_SPRITE_MOSAIC_Y_SHIFT 6    ///> The bitshift for start of OAM sprite mosaic y
+#define GBC_OAM_SPRITE_AFFINE_FLAG 0x04          ///> Flag for an affine sprite
+#define GBC_OAM_SPRITE_DOUBLE_SIZE_FLAG 0x08     ///> Flag for an affine sprite's double size bounding box
+#define GBC_OAM_SPRITE_AFFINE_MATRIX_MASK 0xF0   ///> Mask for OAM sprite affine matrix, shared with the mosaic bits
+#define GBC_OAM_SPRITE_AFFINE_MATRIX_START 0x10  ///> LSB of the OAM sprite affine matrix
+#define GBC_OAM_SPRITE_AFFINE_MATRIX_SHIFT 4     ///> The bitshift for start of OAM sprite affine matrix
 
 /** Helpful macros */
 #define GBC_MIN(x, y) ((y) ^ (((x) ^ (y)) & -((x) < (y)))) ///> Finds the minimum of two values
 #define GBC_MAX(x, y) ((x) ^ (((x) ^ (y)) & -((x) < (y)))) ///> Finds the maximum of two values
-#define GBC_POINT_TO_OFFSET(x, y) ((x) & (GBC_TILEMAP_WIDTH - 1)) + ((y) & (GBC_TILEMAP_HEIGHT - 1)) * GBC_TILEMAP_WIDTH ///> Converts an x, y point on a bg map to the tile/attrmap offset
+#define GBC_POINT_TO_OFFSET(x, y) ((x) & (GBC_TILEMAP_WIDTH - 1)) + ((y) & (GBC_TILEMAP_HEIGHT - 1)) * GBC_TILEMAP_WIDTH ///> Converts an x, y point on a 32 x 32 bg map to the tile/attrmap offset
 #define GBC_SUB_FLOOR(a, b) ((a) - GBC_MIN((a), (b))) ///> Subtracts b from a flooring at zero
 #define GBC_ADD_CEIL(a, b, m) GBC_MIN((a) + (b), (m)) ///> Adds a to b, ceil at m
 #define GBC_GET_RED(c) (((c) >> 4) & 0b11)
 #define GBC_GET_GREEN(c) (((c) >> 2) & 0b11)
 #define GBC_GET_BLUE(c) (((c) >> 0) & 0b11)
 #define GBC_MAKE_COLOR(r, g, b) (0b11000000 | ((r) << 4) | ((g) << 2) | ((b) << 0))
+#define GBC_FADE_CHANNEL(c, t, a) (((c) * (GBC_FADE_MAX - (a)) + (t) * (a) + (GBC_FADE_MAX >> 1)) >> 4) ///> Fades a 2 bit color channel c towards t by a sixteenths, rounded
 
 /** Predefined Screen boundaries for convenience*/
 #if defined(PBL_ROUND)
@@ -169,10 +264,100 @@
 
 /** Colors for black and white palettes */
 #define GBC_COLOR_BLACK 0b00
-#define GBC_COLOR_ALPHA_GRAY 0b01 // Won't actually show up, but is useful for alpha operations
+#define GBC_COLOR_ALPHA_GRAY 0b01 // Only shows up with the Bayer and lines dithers, but is useful for alpha operations
 #define GBC_COLOR_GRAY 0b10
 #define GBC_COLOR_WHITE 0b11
 
+/**
+ * Decoded sprite data, stored as one array per field so the renderer can read sprites
+ * without unpacking OAM bytes. Kept in sync with OAM by the OAM setters
+ */
+typedef struct _gbc_sprite_cache {
+    short *x; ///> Sprite x positions relative to the screen origin, offset removed
+    short *y; ///> Sprite y positions relative to the screen origin, offset removed
+    uint8_t *width; ///> Sprite widths in pixels
+    uint8_t *height; ///> Sprite heights in pixels
+    uint8_t **tiles; ///> Pointers to the first tile of each sprite in VRAM
+    uint8_t *palette_offsets; ///> Offsets of each sprite's palette in the sprite palette bank
+    uint8_t *attrs; ///> Sprite attribute bytes, for the flip and hide flags
+#if GBC_CONFIG_MOSAIC
+    uint8_t *mosaic_x; ///> Sprite mosaic x shifts
+    uint8_t *mosaic_y; ///> Sprite mosaic y shifts
+#endif
+    uint8_t *affine_matrix; ///> Sprite affine matrix numbers, GBC_SPRITE_NOT_AFFINE for regular sprites
+    uint8_t *size_shift; ///> The bitshift from sprite size to bounding box size, 1 for double size affine sprites
+} GBC_Sprite_Cache;
+
+/**
+ * A sprite's position in its tiles, or a background's position in its map, at the current pixel of the
+ * line being rendered, and how far that position moves per pixel. Positions are in 8.8 fixed point, so each pixel only costs two adds
+ */
+typedef struct _gbc_line_step {
+    int32_t u; ///> The x position on the sprite or map
+    int32_t v; ///> The y position on the sprite or map
+    int16_t du; ///> The change in u per pixel
+    int16_t dv; ///> The change in v per pixel
+} GBC_Line_Step;
+
+/**
+ * An app owned image of 8 bit GColor pixels, drawn by a direct color background from the top left of its map
+ */
+typedef struct _gbc_direct_image {
+    uint8_t *pixels; ///> The image's pixels, row by row
+    uint16_t width; ///> The width of the image in pixels, up to the pixel width of the background's map
+    uint16_t height; ///> The height of the image in pixels, up to the pixel height of the background's map
+} GBC_Direct_Image;
+
+/**
+ * A range of colors in one of the palette banks that changes every few frames, stepped at the end of each rendered frame
+ * Ranges can cross from one palette into the next
+ */
+typedef struct _gbc_palette_animation {
+    uint8_t *keyframes; ///> The colors of each keyframe one after another, or NULL to rotate the colors instead
+    uint8_t flags; ///> The palette animation flags
+    uint8_t start; ///> The position of the first color in the palette bank, palette_num * GBC_PALETTE_NUM_BYTES + color_num
+    uint8_t num_colors; ///> The number of colors in the range
+    uint8_t num_keyframes; ///> The number of keyframes
+    uint8_t period; ///> The number of frames between steps
+    uint8_t timer; ///> The number of frames left until the next step - READ ONLY
+    uint8_t keyframe; ///> The keyframe currently shown - READ ONLY
+} GBC_Palette_Animation;
+
+/**
+ * The start of every snapshot, followed by the saved state (or the changes to it, for delta snapshots)
+ * A snapshot can only be restored into an object with the same number of backgrounds, map sizes, VRAM banks, and sprites
+ */
+typedef struct _gbc_snapshot_header {
+    uint16_t magic; ///> GBC_SNAPSHOT_MAGIC, or GBC_SNAPSHOT_DELTA_MAGIC for delta snapshots
+    uint8_t subsystems; ///> The parts of the state in the snapshot, see the snapshot flags
+    uint8_t num_backgrounds; ///> The number of backgrounds of the object the snapshot was taken from
+    uint8_t map_sizes[4]; ///> The map sizes of the object the snapshot was taken from
+    uint8_t num_vram_banks; ///> The number of VRAM banks of the object the snapshot was taken from
+    uint8_t reserved; ///> Unused, always 0
+    uint16_t num_sprites; ///> The number of sprites of the object the snapshot was taken from
+    uint32_t num_bytes; ///> The size of the whole snapshot, including this header
+} GBC_Snapshot_Header;
+
+/**
+ * One sprite of a metasprite, placed relative to the metasprite's origin
+ */
+typedef struct _gbc_metasprite_part {
+    int16_t x; ///> The x offset of the part's left edge from the metasprite's origin
+    int16_t y; ///> The y offset of the part's top edge from the metasprite's origin
+    uint8_t tile_offset; ///> Added to the metasprite's tile position to get the part's tile position
+    uint8_t attrs; ///> Combined with the metasprite's attributes, the flips are XOR'd and the palette and VRAM bank numbers are added
+    uint8_t width; ///> The part's width in tiles + 1, 0-15
+    uint8_t height; ///> The part's height in tiles + 1, 0-15
+} GBC_Metasprite_Part;
+
+/**
+ * A character or object built out of several sprites, written to consecutive OAM entries at once
+ */
+typedef struct _gbc_metasprite {
+    const GBC_Metasprite_Part *parts; ///> The metasprite's parts, in the order they go into OAM
+    uint8_t num_parts; ///> The number of parts
+} GBC_Metasprite;
+
 /** The GBC Graphics "class" struct */
 typedef struct _gbc_graphics GBC_Graphics;
 struct _gbc_graphics {
@@ -190,6 +375,7 @@ struct _gbc_graphics {
      *      e.g. @ z = 0, sprite renders on top of BG 1 and below BG 2, BG 3, BG 4
      */
     uint8_t lcdc;
+#if GBC_CONFIG_ALPHA
     /**
      * The Alpha Mode Word
      *  -Bit 0: BG 1 Display Enable - Setting bit to 1 enables alpha mode on BG 1
@@ -209,6 +395,33 @@ struct _gbc_graphics {
      *  -Bits 13-15: BG 4 Alpha Mode - Sets the alpha mode for BG 4
     */
     uint16_t a_mode;
+#endif
+    /**
+     * Fade Registers - Fade the palettes towards a color without changing them, like the GBA's brightness registers
+     * The faded palettes are built at the start of the frame, and again before any line where the fade registers have changed,
+     * so fading costs nothing per pixel, and setting them in the line compare or HBlank callbacks fades part of the screen
+     */
+    uint8_t fade_targets; ///> The palettes to fade, see the fade flags
+    uint8_t fade_color; ///> The color to fade towards, e.g. white to brighten or black to darken
+    uint8_t fade_amount; ///> How far to fade, from 0 for none to GBC_FADE_MAX for entirely the fade color
+    uint8_t *bg_faded_palette_bank; ///> The background palettes with the fade applied - READ ONLY
+    uint8_t *sprite_faded_palette_bank; ///> The sprite palettes with the fade applied - READ ONLY
+    uint16_t fade_dirty_palettes; ///> The palettes changed since they were last faded, see the dirty palette flags - READ ONLY
+    /**
+     * The Dither Mode Word - Picks how each layer's grays are drawn on black and white Pebbles, ignored on color
+     *  -Bits 0-1: BG 1 Dither Mode
+     *      -Mode 0: Checker - Gray is a 2x2 checkerboard, alpha gray is black
+     *      -Mode 1: Bayer - Gray and alpha gray use a 4x4 ordered dither, 50% and 25% white
+     *      -Mode 2: Lines - Gray is every other line, alpha gray every fourth
+     *      -Mode 3: None - Gray draws as white, alpha gray as black
+     *  -Bits 2-3: BG 2 Dither Mode
+     *  -Bits 4-5: BG 3 Dither Mode
+     *  -Bits 6-7: BG 4 Dither Mode
+     *  -Bits 8-9: Sprite Dither Mode
+     * Each pixel uses the dither of the top layer drawn on it. The patterns are stored as a row mask per line,
+     * so the output stage only looks up a bit for each pixel
+     */
+    uint16_t dither_mode;
     /**
      * VRAM Buffer - Stores the tiles for the backgrounds and sprites in a 4bpp format
      * Originally, the VRAM contained 4 banks of 8192 bytes, for a total of 32768 bytes
@@ -216,9 +429,21 @@ struct _gbc_graphics {
      * Each bank holds up to 256 tiles in 4bpp format of 32 bytes each
      */
     uint8_t *vram;
+    /**
+     * Tile Collision Flags - The collision flags of each tile in VRAM, by tile number from 0 to num_vram_banks * 256 - 1
+     * (the same numbers as wide maps use). The flags are for the app to define, e.g. solid, water, or damage,
+     * and tiles with no flags set don't collide. NULL until the first tile's flags are set - READ ONLY
+     */
+    uint8_t *tile_collision_flags;
+    /**
+     * Tile Masks - A 1 bit occupancy mask of each tile in VRAM, 8 bytes per tile, one per row with the leftmost pixel
+     * in the highest bit and a bit set for each non-zero pixel. Rebuilt as tiles are loaded or moved, and used for pixel precise collisions.
+     * After writing to VRAM directly, call GBC_Graphics_collision_update_tile_masks. NULL unless enabled - READ ONLY
+     */
+    uint8_t *tile_masks;
     /**
      * OAM Buffer - Stores the data for the current sprites
-     * The OAM contains 40 slots for 5 bytes of sprite information, which is as follows:
+     * The OAM contains num_sprites slots (40 by default) for 6 bytes of sprite information, which is as follows:
      *  -Byte 0: Sprite x position, offset by -128 (max sprite width) to allow for off-screen rendering
      *  -Byte 1: Sprite y position, offset by -128 (max sprite height) to allow for off-screen rendering
      *  -Byte 2: Sprite tile position in VRAM bank
@@ -235,24 +460,49 @@ struct _gbc_graphics {
      *  - Byte 5: Extra sprite data
      *      -Bit 0: Upper sprite x position bit
      *      -Bit 1: Upper sprite y position bit
-     *      -Bits 2-3: Unused
+     *      -Bit 2: Affine - Setting the bit will rotate and scale the sprite by its affine matrix, ignoring the flip flags
+     *      -Bit 3: Double Size - Setting the bit doubles an affine sprite's bounding box, so it isn't clipped when rotated or scaled up
      *      -Bits 4-5: Sprite mosaic x, from 0-3
      *      -Bits 6-7: Sprite mosaic y, from 0-3
+     *      -Bits 4-7: Affine matrix number, from 0-15, replaces the mosaic on affine sprites
      */
     uint8_t *oam;
+    uint16_t num_sprites; ///> The number of sprite slots in OAM
+    GBC_Sprite_Cache sprite_cache; ///> The decoded OAM data used by the renderer
+    /**
+     * Sprite Bins - An index of which sprites are on which lines, kept up to date by the OAM setters
+     * Each bin covers 8 lines of the screen, and is a bitset with a bit for each sprite that overlaps those lines
+     * The renderer only has to check the sprites in the current line's bin, rather than all of OAM
+     */
+    uint32_t *sprite_bins;
+    uint16_t sprite_bin_words; ///> The number of 32 bit words per sprite bin
+    uint16_t *line_sprites; ///> Scratch list of the sprites on the line being rendered
+    GBC_Line_Step *line_sprite_steps; ///> Scratch positions of the sprites on the line being rendered
+    /**
+     * Sprite Affine Matrices - The 16 matrices affine sprites can select, 4 values each
+     * Each matrix maps a step on the screen to a step on the sprite, in 8.8 fixed point:
+     *  -Value 0 (pa): Change in sprite x per screen x
+     *  -Value 1 (pb): Change in sprite x per screen y
+     *  -Value 2 (pc): Change in sprite y per screen x
+     *  -Value 3 (pd): Change in sprite y per screen y
+     * e.g. {GBC_AFFINE_ONE, 0, 0, GBC_AFFINE_ONE} draws the sprite unchanged, {GBC_AFFINE_ONE / 2, 0, 0, GBC_AFFINE_ONE / 2} doubles it
+     */
+    int16_t *sprite_affine_matrices;
     /**
      * Background Tilemap buffers
-     * This tilemap contains 1-4 32 x 32 VRAM bank locations of 1 byte each, totaling 512 * num_backgrounds bytes
+     * This tilemap contains 1-4 maps of VRAM bank locations of 1 byte each, one after another, 32 x 32 tiles (1024 bytes) each by default
+     * Each background's map starts at its bg_tilemap_offsets entry, and is bg_map_sizes wide and tall
+     * Wide maps hold a uint16_t per tile instead, a tile number from 0 to 1023 across all of the VRAM banks
      * The offset of the screen view is set by bg_scroll_x and bg_scroll_y
      */
     uint8_t *bg_tilemaps;
     /**
      * Background Atributemap Buffers
-     * This tilemap contains 4 of 32 x 32 tile attributes of 1 byte each, totaling 4096 bytes
+     * This tilemap contains 1-4 maps of tile attributes of 1 byte each, one after another, starting at each bg_attrmap_offsets entry
      * Each attribute corresponds to a tile on the bg_tilemap
      * The attribute byte is defined as:
      *      -Bits 0-2: Palette number, from 0 to 7
-     *      -Bits 3-4: VRAM Bank Select, from 0 to 3
+     *      -Bits 3-4: VRAM Bank Select, from 0 to 3, unused by wide maps
      *      -Bit 5: X Flip - Setting bit will flip the tile horizontally when rendered
      *      -Bit 6: Y Flip - Setting bit will flip the tile vertically when rendered
      *      -Bit 7: Hide - Setting the bit will make the tile hidden
@@ -269,8 +519,91 @@ struct _gbc_graphics {
      * The 0th color in each palette will be replaced by transparency when rendered.
      */
     uint8_t *sprite_palette_bank;
+    GBC_Palette_Animation *palette_animations; ///> The palette animations, GBC_NUM_PALETTE_ANIMATIONS of them
+    /**
+     * Dirty Palettes - The palettes changed since the last frame was rendered, see the dirty palette flags
+     *  -Bits 0-7: Background palettes 0-7
+     *  -Bits 8-15: Sprite palettes 0-7
+     * Set by the palette functions and palette animations, but not by writing to the palette banks directly - READ ONLY
+     */
+    uint16_t dirty_palettes;
+    /**
+     * Background Map Sizes - Array of 4 map sizes, one per background, set by the constructor - READ ONLY
+     *  -Bits 0-3: log2 of the map height in tiles, from 4-7
+     *  -Bits 4-6: log2 of the map width in tiles, from 4-7
+     *  -Bit 7: Wide tiles - The map holds 16 bit tile numbers
+     */
+    uint8_t *bg_map_sizes;
+    uint16_t *bg_tilemap_offsets; ///> Array of 4 offsets in bytes of each background's map into the tilemaps - READ ONLY
+    uint16_t *bg_attrmap_offsets; ///> Array of 4 offsets of each background's map into the attrmaps - READ ONLY
     short *bg_scroll_x; ///> Array of 4 x positions of the screen view into the background tilemaps
     short *bg_scroll_y; ///> Array of 4 y position of the screen view into the background tilemaps
+    /**
+     * The BG Affine Byte
+     *  -Bits 0-3: BG 1-4 Affine Enable - Setting a bit draws that background with its affine parameters instead of its scroll position
+     *  -Bits 4-7: BG 1-4 Affine Clip - Setting a bit hides an affine background outside its tilemap, instead of wrapping around
+     */
+    uint8_t bg_affine;
+    /**
+     * Background Affine Parameters - 4 values for each background, mapping steps on the screen to steps on the tilemap in 8.8 fixed point:
+     *  -Value 0 (dx): Change in map x per screen x
+     *  -Value 1 (dmx): Change in map x per screen line
+     *  -Value 2 (dy): Change in map y per screen x
+     *  -Value 3 (dmy): Change in map y per screen line
+     * They're read at the start of every line, so changing them in the line compare or HBlank callbacks gives per-line effects like perspective floors
+     */
+    int16_t *bg_affine_params;
+    int32_t *bg_affine_ref_x; ///> Array of 4 map x positions (8.8 fixed point) drawn at the top left of the screen by affine backgrounds
+    int32_t *bg_affine_ref_y; ///> Array of 4 map y positions (8.8 fixed point) drawn at the top left of the screen by affine backgrounds
+    int32_t *bg_affine_line_x; ///> Array of 4 map x positions drawn at the start of the current line, stepped by dmx every line - READ ONLY
+    int32_t *bg_affine_line_y; ///> Array of 4 map y positions drawn at the start of the current line, stepped by dmy every line - READ ONLY
+    GBC_Line_Step *line_bg_steps; ///> Scratch positions of the backgrounds on the line being rendered
+#if GBC_CONFIG_MOSAIC
+    /**
+     * Background Mosaic - 1 byte for each background, splitting it into blocks that each show the pixel at their top left:
+     *  -Bits 0-3: Mosaic width - 1, from 0-15 for blocks 1-16 pixels wide
+     *  -Bits 4-7: Mosaic height - 1, from 0-15 for blocks 1-16 pixels tall
+     * Blocks start at the top left of the screen, and each block only reads the map once per line
+     */
+    uint8_t *bg_mosaic;
+#endif
+    /**
+     * The BG Direct Color Byte
+     *  -Bits 0-3: BG 1-4 Direct Color Enable - Setting a bit draws that background from its direct image instead of its tilemap
+     * Direct color pixels are GColors, drawn without going through the palettes (so they aren't faded), and transparent where
+     * their alpha is 0. On black and white Pebbles the green channel is drawn as the GBC color. Unscaled lines are copied out
+     * of the image with memcpy before the line is drawn, and affine or mosaic direct color backgrounds read the image per pixel
+     */
+    uint8_t bg_direct_color;
+    GBC_Direct_Image *bg_direct_images; ///> Array of 4 direct images, one per background
+    uint8_t *line_direct_pixels; ///> Scratch lines copied out of the direct images, 256 bytes per background - READ ONLY
+    /**
+     * The BG Cache Byte
+     *  -Bits 0-3: BG 1-4 Cache Enable - Setting a bit renders that background into a buffer of the screen once, 
+     *             and reads it back every frame until something changes the background
+     * The buffers hold each pixel's palette bank offset, so palette changes, fades, and palette animations don't need a rerender.
+     * The background, VRAM, affine, mosaic, direct color, and screen setters invalidate the caches they change. 
+     * After writing to the tilemaps, attrmaps, or VRAM directly, call GBC_Graphics_bg_invalidate_cache. Direct color backgrounds aren't cached
+     */
+    uint8_t bg_cached;
+    uint8_t bg_cache_valid; ///> The cached backgrounds whose buffers are up to date - READ ONLY
+    uint8_t bg_cache_filling; ///> The cached backgrounds being rendered into their buffers this frame - READ ONLY
+    uint8_t **bg_caches; ///> Array of 4 cache buffers of screen_width * screen_height bytes, NULL for uncached backgrounds - READ ONLY
+    /**
+     * Shadow Registers - While shadowing is enabled, OAM, the sprite affine matrices, the scroll registers, the palette banks, 
+     * and LCDC are written as usual, but the renderer reads render copies of them that are latched at the start of each frame.
+     * Changes made while a frame is drawn, including from its interrupt callbacks, all show together on the next frame.
+     * Without shadowing, the render pointers point at the registers themselves
+     */
+    uint8_t *shadow_buffer; ///> The render copies, NULL when shadowing is disabled - READ ONLY
+    GBC_Sprite_Cache render_sprite_cache; ///> The decoded sprites the renderer reads - READ ONLY
+    uint32_t *render_sprite_bins; ///> The sprite bins the renderer reads - READ ONLY
+    int16_t *render_sprite_affine_matrices; ///> The sprite affine matrices the renderer reads - READ ONLY
+    short *render_bg_scroll_x; ///> The background x scroll registers the renderer reads - READ ONLY
+    short *render_bg_scroll_y; ///> The background y scroll registers the renderer reads - READ ONLY
+    uint8_t *render_bg_palette_bank; ///> The background palette bank the renderer reads - READ ONLY
+    uint8_t *render_sprite_palette_bank; ///> The sprite palette bank the renderer reads - READ ONLY
+    uint8_t *render_lcdc; ///> The LCDC byte the renderer reads - READ ONLY
     /**
      * LCD Status Byte
      *  -Bit 0: HBlank Flag - Set to 1 between rendering lines - READ ONLY
@@ -291,10 +624,17 @@ struct _gbc_graphics {
     void (*oam_interrupt_callback)(GBC_Graphics *); ///> The callback for the oam interrupt
 
     uint8_t num_backgrounds; ///> The number of background layers
+    uint8_t num_vram_banks; ///> The number of VRAM banks
     uint8_t screen_x_origin; ///> The start x position of the rendered screen
     uint8_t screen_y_origin; ///> The start y position of the rendered screen
     uint8_t screen_width; ///> The width of the rendered screen
     uint8_t screen_height; ///> The height of the rendered screen
+
+    uint8_t sprite_line_limit; ///> The max number of sprites rendered on one line, 0 for no limit
+    bool sprite_flicker_enabled; ///> If true, the sprites dropped by the line limit rotate every frame
+    uint8_t sprite_flicker_offset; ///> The rotation into each line's sprites when flicker is enabled - READ ONLY
+
+    bool owns_buffer; ///> If true, the object's buffer was allocated by the constructor and is freed by GBC_Graphics_destroy - READ ONLY
 };
 
 /**
@@ -312,6 +652,65 @@ struct _gbc_graphics {
  */
 GBC_Graphics *GBC_Graphics_ctor(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds);
 
+/**
+ * Creates a GBC Graphics object with room for more (or fewer) than 40 sprites
+ * 
+ * @param window The window in which to display the GBC Graphics object
+ * @param num_vram_banks The number of vram banks to generate, can be from 1-4
+ * @param num_backgrounds The number of background layers to generate, can be from 1-4
+ * @param num_sprites The number of sprite slots in OAM
+ * 
+ * @return a pointer to the created GBC Graphics object
+ * @note Each sprite slot costs 40 bytes: 6 for OAM, 16 for the sprite cache, 4 for the sprite bins, and 14 for the line scratch lists
+ * @note The object and all of its buffers are allocated at once, see GBC_Graphics_get_footprint for the size
+ */
+GBC_Graphics *GBC_Graphics_ctor_with_num_sprites(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites);
+
+/**
+ * Creates a GBC Graphics object with background maps larger (or smaller) than 32 x 32 tiles
+ * 
+ * @param window The window in which to display the GBC Graphics object
+ * @param num_vram_banks The number of vram banks to generate, can be from 1-4
+ * @param num_backgrounds The number of background layers to generate, can be from 1-4
+ * @param num_sprites The number of sprite slots in OAM
+ * @param map_sizes An array of num_backgrounds map sizes, e.g. GBC_MAP_SIZE_64X32, or NULL for 32 x 32 maps
+ * 
+ * @return a pointer to the created GBC Graphics object
+ * @note Each map costs 2 bytes per tile, for its tilemap and attrmap, so a 64 x 64 map takes 8192 bytes
+ * @note Maps with GBC_MAP_WIDE_TILES_FLAG cost 3 bytes per tile, and pick from all of VRAM without using the attributes' VRAM bank
+ */
+GBC_Graphics *GBC_Graphics_ctor_with_map_sizes(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, const uint8_t *map_sizes);
+
+/**
+ * Creates a GBC Graphics object in a buffer the app provides, such as a static array, instead of allocating it
+ * 
+ * @param window The window in which to display the GBC Graphics object
+ * @param num_vram_banks The number of vram banks to generate, can be from 1-4
+ * @param num_backgrounds The number of background layers to generate, can be from 1-4
+ * @param num_sprites The number of sprite slots in OAM
+ * @param map_sizes An array of num_backgrounds map sizes, or NULL for 32 x 32 maps
+ * @param buffer A pointer to the buffer, at least GBC_Graphics_get_footprint bytes and aligned to GBC_ARENA_ALIGNMENT
+ * 
+ * @return a pointer to the created GBC Graphics object, which is at the start of the buffer
+ * @note GBC_Graphics_destroy still needs to be called, but the buffer is left for the app to free
+ */
+GBC_Graphics *GBC_Graphics_ctor_in_buffer(Window *window, uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, 
+                                          const uint8_t *map_sizes, void *buffer);
+
+/**
+ * Gets the number of bytes a GBC Graphics object takes up, including its vram, maps, palettes, and OAM,
+ * so it can be checked against the free heap before creating it
+ * 
+ * @param num_vram_banks The number of vram banks
+ * @param num_backgrounds The number of background layers
+ * @param num_sprites The number of sprite slots in OAM
+ * @param map_sizes An array of num_backgrounds map sizes, or NULL for 32 x 32 maps
+ * 
+ * @return The size of the object and its buffers in bytes
+ * @note This doesn't include the Layer, or the buffers allocated later for cached or direct color backgrounds
+ */
+size_t GBC_Graphics_get_footprint(uint8_t num_vram_banks, uint8_t num_backgrounds, uint16_t num_sprites, const uint8_t *map_sizes);
+
 /**
  * Destroys the GBC Graphics display object by freeing any memory it uses
  * 
@@ -546,6 +945,56 @@ void GBC_Graphics_copy_one_sprite_palette(GBC_Graphics *self, uint8_t palette_nu
  */
 void GBC_Graphics_copy_all_sprite_palettes(GBC_Graphics *self, uint8_t *target_array);
 
+/**
+ * Starts a palette animation that rotates a range of colors by one place every period frames,
+ * with each color moving to the one before it, and the first color wrapping around to the end
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param animation_num The palette animation to start, from 0 to GBC_NUM_PALETTE_ANIMATIONS - 1
+ * @param is_sprite_palette Should the sprite palettes be animated, instead of the background palettes?
+ * @param palette_num The palette of the first color, from 0 to 7
+ * @param color_num The first color, from 0 to 15
+ * @param num_colors The number of colors to rotate, which can continue into the following palettes
+ * @param period The number of frames between rotations, at least 1
+ */
+void GBC_Graphics_palette_animation_set_rotation(GBC_Graphics *self, uint8_t animation_num, bool is_sprite_palette, 
+                                                 uint8_t palette_num, uint8_t color_num, uint8_t num_colors, uint8_t period);
+
+/**
+ * Starts a palette animation that copies each keyframe into a range of colors in turn, every period frames, looping back to the first
+ * The first keyframe is copied in straight away
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param animation_num The palette animation to start, from 0 to GBC_NUM_PALETTE_ANIMATIONS - 1
+ * @param is_sprite_palette Should the sprite palettes be animated, instead of the background palettes?
+ * @param palette_num The palette of the first color, from 0 to 7
+ * @param color_num The first color, from 0 to 15
+ * @param num_colors The number of colors in each keyframe, which can continue into the following palettes
+ * @param keyframes A pointer to num_keyframes * num_colors colors, which must stay valid while the animation runs
+ * @param num_keyframes The number of keyframes
+ * @param period The number of frames between keyframes, at least 1
+ */
+void GBC_Graphics_palette_animation_set_keyframes(GBC_Graphics *self, uint8_t animation_num, bool is_sprite_palette, 
+                                                  uint8_t palette_num, uint8_t color_num, uint8_t num_colors, 
+                                                  uint8_t *keyframes, uint8_t num_keyframes, uint8_t period);
+
+/**
+ * Stops a palette animation, leaving its colors as they are
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param animation_num The palette animation to stop, from 0 to GBC_NUM_PALETTE_ANIMATIONS - 1
+ */
+void GBC_Graphics_palette_animation_stop(GBC_Graphics *self, uint8_t animation_num);
+
+/**
+ * Gets the palettes changed since the last frame was rendered (see the dirty palettes description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * 
+ * @return The dirty palette flags of the changed palettes
+ */
+uint16_t GBC_Graphics_get_dirty_palettes(GBC_Graphics *self);
+
 /**
  * Renders the background, window, and sprite layers at the next available opportunity
  * 
@@ -553,6 +1002,43 @@ void GBC_Graphics_copy_all_sprite_palettes(GBC_Graphics *self, uint8_t *target_a
  */
 void GBC_Graphics_render(GBC_Graphics *self);
 
+/**
+ * Renders the background, window, and sprite layers into a bitmap right away, instead of the screen,
+ * e.g. for a screenshot to transition from, or a thumbnail of the scene
+ * The scene is drawn at the screen bounds, so set those for the size and position to draw at,
+ * and anything past the right or bottom edge of the bitmap is clipped
+ * This draws a copy of the scene without moving on the frame on screen, so no interrupt callbacks run,
+ * the palette animations and sprite flicker don't step, and the dirty palettes are left as they are
+ * With shadow registers enabled, the registers latched for the last frame on screen are drawn
+ * Cached backgrounds are drawn from their tiles and their caches are left as they are
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bitmap A pointer to the bitmap to draw into, which must be GBitmapFormat8Bit on color Pebbles
+ *               (or GBitmapFormat8BitCircular on round Pebbles) and GBitmapFormat1Bit on black and white Pebbles,
+ *               otherwise nothing is drawn
+ */
+void GBC_Graphics_render_to_bitmap(GBC_Graphics *self, GBitmap *bitmap);
+
+/**
+ * Enables or disables the shadow registers (see the shadow registers description)
+ * While enabled, changes to OAM, the scroll registers, the palettes, and LCDC show from the start of the next frame,
+ * so game logic and the interrupt callbacks can change them at any time without tearing the frame being drawn
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param enabled Should the registers be shadowed?
+ * @note The render copies take around 1KB with 40 sprites, and are allocated when shadowing is enabled
+ */
+void GBC_Graphics_shadow_set_enabled(GBC_Graphics *self, bool enabled);
+
+/**
+ * Copies the shadowed registers into the render copies right away, instead of at the start of the next frame,
+ * e.g. from the line compare callback for a change that should show partway down the screen
+ * Does nothing while shadowing is disabled
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ */
+void GBC_Graphics_shadow_latch(GBC_Graphics *self);
+
 /**
  * Sets the LCDC byte
  * 
@@ -613,6 +1099,74 @@ void GBC_Graphics_alpha_mode_set_bg_enabled(GBC_Graphics *self, uint8_t bg_num,
  */
 void GBC_Graphics_alpha_mode_set_mode(GBC_Graphics *self, uint8_t bg_num, uint8_t mode);
 
+/**
+ * Sets the palettes affected by the fade (see the fade flags)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param targets The fade flags of the palettes to fade
+ */
+void GBC_Graphics_fade_set_targets(GBC_Graphics *self, uint8_t targets);
+
+/**
+ * Sets the color the palettes fade towards
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param color The color to fade towards
+ */
+void GBC_Graphics_fade_set_color(GBC_Graphics *self, uint8_t color);
+
+/**
+ * Sets how far the palettes fade towards the fade color
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param amount The fade amount, from 0 for none to GBC_FADE_MAX for entirely the fade color
+ */
+void GBC_Graphics_fade_set_amount(GBC_Graphics *self, uint8_t amount);
+
+/**
+ * Brightens or darkens the target palettes, fading towards white or black
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param brightness From -GBC_FADE_MAX for black, through 0 for unchanged, to GBC_FADE_MAX for white
+ */
+void GBC_Graphics_fade_set_brightness(GBC_Graphics *self, int8_t brightness);
+
+/**
+ * Sets the dither mode a background's grays are drawn with on black and white Pebbles
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_num The background to set, 0-3
+ * @param mode The dither mode, 0-3 (see the dither modes)
+ */
+void GBC_Graphics_dither_set_bg_mode(GBC_Graphics *self, uint8_t bg_num, uint8_t mode);
+
+/**
+ * Sets the dither mode the sprites' grays are drawn with on black and white Pebbles
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param mode The dither mode, 0-3 (see the dither modes)
+ */
+void GBC_Graphics_dither_set_sprite_mode(GBC_Graphics *self, uint8_t mode);
+
+/**
+ * Gets the dither mode of a background
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_num The background to get, 0-3
+ * 
+ * @return The background's dither mode
+ */
+uint8_t GBC_Graphics_dither_get_bg_mode(GBC_Graphics *self, uint8_t bg_num);
+
+/**
+ * Gets the dither mode of the sprites
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * 
+ * @return The sprites' dither mode
+ */
+uint8_t GBC_Graphics_dither_get_sprite_mode(GBC_Graphics *self);
+
 /**
  * Gets the current line being rendered
  * 
@@ -814,7 +1368,7 @@ bool GBC_Graphics_attr_is_hidden(uint8_t attributes);
  * 
  * @return The current x position of the background scroll
  */
-uint8_t GBC_Graphics_bg_get_scroll_x(GBC_Graphics *self, uint8_t bg_layer);
+short GBC_Graphics_bg_get_scroll_x(GBC_Graphics *self, uint8_t bg_layer);
 
 /**
  * Gets the current y position of the background scroll
@@ -824,27 +1378,59 @@ uint8_t GBC_Graphics_bg_get_scroll_x(GBC_Graphics *self, uint8_t bg_layer);
  * 
  * @return The current y position of the background scroll
  */
-uint8_t GBC_Graphics_bg_get_scroll_y(GBC_Graphics *self, uint8_t bg_layer);
+short GBC_Graphics_bg_get_scroll_y(GBC_Graphics *self, uint8_t bg_layer);
+
+/**
+ * Gets the width of a background's map
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * 
+ * @return The width of the map in tiles
+ */
+uint8_t GBC_Graphics_bg_get_map_width(GBC_Graphics *self, uint8_t bg_layer);
+
+/**
+ * Gets the height of a background's map
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * 
+ * @return The height of the map in tiles
+ */
+uint8_t GBC_Graphics_bg_get_map_height(GBC_Graphics *self, uint8_t bg_layer);
 
 /**
  * Gets the tile number at the given position on the background
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * 
- * @return The tile number
+ * @return The tile number, which is only the lower 8 bits on wide maps
  */
 uint8_t GBC_Graphics_bg_get_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y);
 
+/**
+ * Gets the tile number at the given position on the background, counting across all of the VRAM banks
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
+ * 
+ * @return The tile number, vram_bank * 256 + tile number within the bank
+ */
+uint16_t GBC_Graphics_bg_get_wide_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y);
+
 /** 
  * Gets the attributes of the tile at the given position on the background
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * 
  * @return The tile attributes
  */
@@ -852,7 +1438,7 @@ uint8_t GBC_Graphics_bg_get_attr(GBC_Graphics *self, uint8_t bg_layer, uint8_t x
 
 /**
  * Moves the background scroll by dx and dy
- * X and Y will wrap around if they become < 0 or > MAP_SIZE * GBC_TILE_NUM_BYTES
+ * X and Y will wrap around if they become < 0 or >= the map's size in pixels
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
@@ -866,18 +1452,18 @@ void GBC_Graphics_bg_move(GBC_Graphics *self, uint8_t bg_layer, short dx, short
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The new scroll x
+ * @param x The new scroll x, from 0 to the map's width in pixels
  */
-void GBC_Graphics_bg_set_scroll_x(GBC_Graphics *self, uint8_t bg_layer, uint8_t x);
+void GBC_Graphics_bg_set_scroll_x(GBC_Graphics *self, uint8_t bg_layer, short x);
 
 /**
  * Sets the background scroll y
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param y The new scroll y
+ * @param y The new scroll y, from 0 to the map's height in pixels
  */
-void GBC_Graphics_bg_set_scroll_y(GBC_Graphics *self, uint8_t bg_layer, uint8_t y);
+void GBC_Graphics_bg_set_scroll_y(GBC_Graphics *self, uint8_t bg_layer, short y);
 
 /**
  * Sets the background scroll x and scroll y
@@ -887,26 +1473,39 @@ void GBC_Graphics_bg_set_scroll_y(GBC_Graphics *self, uint8_t bg_layer, uint8_t
  * @param x The new scroll x
  * @param y The new scroll y
  */
-void GBC_Graphics_bg_set_scroll_pos(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y);
+void GBC_Graphics_bg_set_scroll_pos(GBC_Graphics *self, uint8_t bg_layer, short x, short y);
 
 /**
  * Sets the tile number at the given position on the background
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param tile_number The new tile number
+ * @note On wide maps this picks a tile from VRAM bank 0, use GBC_Graphics_bg_set_wide_tile for the others
  */
 void GBC_Graphics_bg_set_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t tile_number);
 
+/**
+ * Sets the tile number at the given position on the background, counting across all of the VRAM banks
+ * Wide maps store the whole tile number, other maps store the VRAM bank in the tile's attributes
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
+ * @param tile_number The new tile number, vram_bank * 256 + tile number within the bank, from 0 to 1023
+ */
+void GBC_Graphics_bg_set_wide_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint16_t tile_number);
+
 /**
  * Sets the tile attributes at the given position on the background
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param attributes The new attributes
  */
 void GBC_Graphics_bg_set_attrs(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t attributes);
@@ -916,8 +1515,8 @@ void GBC_Graphics_bg_set_attrs(GBC_Graphics *self, uint8_t bg_layer, uint8_t x,
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param tile_number The new tile number
  * @param attributes The new tile number
  */
@@ -928,8 +1527,8 @@ void GBC_Graphics_bg_set_tile_and_attrs(GBC_Graphics *self, uint8_t bg_layer, ui
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param palette The new palette, from 0 to 7
  */
 void GBC_Graphics_bg_set_tile_palette(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t palette);
@@ -939,9 +1538,10 @@ void GBC_Graphics_bg_set_tile_palette(GBC_Graphics *self, uint8_t bg_layer, uint
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param vram_bank The new VRAM bank, from 0 to 3
+ * @note Wide maps ignore the VRAM bank, it's part of their tile numbers instead
  */
 void GBC_Graphics_bg_set_tile_vram_bank(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, uint8_t vram_bank);
 
@@ -950,8 +1550,8 @@ void GBC_Graphics_bg_set_tile_vram_bank(GBC_Graphics *self, uint8_t bg_layer, ui
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param flipped If the tile should be flipped horizontally
  */
 void GBC_Graphics_bg_set_tile_x_flip(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool flipped);
@@ -961,8 +1561,8 @@ void GBC_Graphics_bg_set_tile_x_flip(GBC_Graphics *self, uint8_t bg_layer, uint8
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param flipped If the tile should be flipped vertically
  */
 void GBC_Graphics_bg_set_tile_y_flip(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool flipped);
@@ -972,8 +1572,8 @@ void GBC_Graphics_bg_set_tile_y_flip(GBC_Graphics *self, uint8_t bg_layer, uint8
  * 
  * @param self A pointer to the target GBC Graphics object
  * @param bg_layer The number of the background layer, from 0 to 3
- * @param x The x position on the background, from 0 to 31
- * @param y The y position on the background, from 0 to 31
+ * @param x The x position on the background, wrapping around the map's width
+ * @param y The y position on the background, wrapping around the map's height
  * @param hidden If the tile should be hidden
  */
 void GBC_Graphics_bg_set_tile_hidden(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y, bool hidden);
@@ -991,6 +1591,137 @@ void GBC_Graphics_bg_set_tile_hidden(GBC_Graphics *self, uint8_t bg_layer, uint8
  */
 void GBC_Graphics_bg_move_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t src_x, uint8_t src_y, uint8_t dest_x, uint8_t dest_y, bool swap);
 
+/**
+ * Sets if the background is drawn with its affine parameters instead of its scroll position
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param enabled Should the background be affine?
+ */
+void GBC_Graphics_bg_set_affine_enabled(GBC_Graphics *self, uint8_t bg_layer, bool enabled);
+
+/**
+ * Sets if an affine background is hidden outside its tilemap, instead of wrapping around
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param clipped Should the background be hidden outside its tilemap?
+ */
+void GBC_Graphics_bg_set_affine_clipped(GBC_Graphics *self, uint8_t bg_layer, bool clipped);
+
+/**
+ * Sets the affine parameters of a background (see the background affine parameters description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param dx The change in map x per screen x, in 8.8 fixed point
+ * @param dmx The change in map x per screen line, in 8.8 fixed point
+ * @param dy The change in map y per screen x, in 8.8 fixed point
+ * @param dmy The change in map y per screen line, in 8.8 fixed point
+ */
+void GBC_Graphics_bg_set_affine_params(GBC_Graphics *self, uint8_t bg_layer, int16_t dx, int16_t dmx, int16_t dy, int16_t dmy);
+
+/**
+ * Sets the map position drawn at the top left of the screen by an affine background
+ * @note When set from the line compare or HBlank callbacks, the following lines continue on from this position
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param x The map x position, in 8.8 fixed point
+ * @param y The map y position, in 8.8 fixed point
+ */
+void GBC_Graphics_bg_set_affine_ref_point(GBC_Graphics *self, uint8_t bg_layer, int32_t x, int32_t y);
+
+/**
+ * Sets the affine parameters and reference point of a background to rotate and scale it
+ * around a point on the map, which is drawn at the given point on the screen
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param angle The clockwise rotation, from 0 to TRIG_MAX_ANGLE
+ * @param scale_x The horizontal scale in 8.8 fixed point, GBC_AFFINE_ONE for no scaling, negative to mirror,
+ *                and kept at least GBC_AFFINE_SCALE_MIN either way around
+ * @param scale_y The vertical scale in 8.8 fixed point, GBC_AFFINE_ONE for no scaling, negative to mirror,
+ *                and kept at least GBC_AFFINE_SCALE_MIN either way around
+ * @param map_x The x position on the map to rotate and scale around, in pixels
+ * @param map_y The y position on the map to rotate and scale around, in pixels
+ * @param screen_x The x position on the screen to draw map_x at, in pixels
+ * @param screen_y The y position on the screen to draw map_y at, in pixels
+ */
+void GBC_Graphics_bg_set_affine_rotation_scale(GBC_Graphics *self, uint8_t bg_layer, int32_t angle, int16_t scale_x, int16_t scale_y, 
+                                               short map_x, short map_y, short screen_x, short screen_y);
+
+/**
+ * Sets the size of a background's mosaic blocks (see the background mosaic description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param width The width of the blocks in pixels, from 1 to 16, 1 for no mosaic
+ * @param height The height of the blocks in pixels, from 1 to 16, 1 for no mosaic
+ */
+void GBC_Graphics_bg_set_mosaic(GBC_Graphics *self, uint8_t bg_layer, uint8_t width, uint8_t height);
+
+/**
+ * Gets the width of a background's mosaic blocks
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * 
+ * @return The width of the blocks in pixels, from 1 to 16
+ */
+uint8_t GBC_Graphics_bg_get_mosaic_width(GBC_Graphics *self, uint8_t bg_layer);
+
+/**
+ * Gets the height of a background's mosaic blocks
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * 
+ * @return The height of the blocks in pixels, from 1 to 16
+ */
+uint8_t GBC_Graphics_bg_get_mosaic_height(GBC_Graphics *self, uint8_t bg_layer);
+
+/**
+ * Sets whether a background draws from its direct image instead of its tilemap (see the direct color description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param enabled Whether the background draws its direct image
+ * @note The first background to enable direct color allocates a line buffer of 256 bytes per background,
+ *       and if that fails the background is left drawing its tilemap
+ */
+void GBC_Graphics_bg_set_direct_color_enabled(GBC_Graphics *self, uint8_t bg_layer, bool enabled);
+
+/**
+ * Sets the image of 8 bit GColor pixels a direct color background draws
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param pixels The image's pixels, row by row, which must stay allocated while the background draws them
+ * @param width The width of the image in pixels, up to the width of the background's map
+ * @param height The height of the image in pixels, up to the height of the background's map
+ */
+void GBC_Graphics_bg_set_direct_image(GBC_Graphics *self, uint8_t bg_layer, uint8_t *pixels, uint16_t width, uint16_t height);
+
+/**
+ * Sets whether a background is cached (see the background cache description)
+ * Cached backgrounds take screen_width * screen_height bytes each
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ * @param cached Whether the background is cached
+ */
+void GBC_Graphics_bg_set_cached(GBC_Graphics *self, uint8_t bg_layer, bool cached);
+
+/**
+ * Marks a background's cache out of date, so it's rerendered next frame
+ * Only needed after writing to the tilemaps, attrmaps, or VRAM directly, the setters do this themselves
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The number of the background layer, from 0 to 3
+ */
+void GBC_Graphics_bg_invalidate_cache(GBC_Graphics *self, uint8_t bg_layer);
+
 /**
  * Gets the x position of the sprite
  * 
@@ -999,7 +1730,7 @@ void GBC_Graphics_bg_move_tile(GBC_Graphics *self, uint8_t bg_layer, uint8_t src
  * 
  * @return The sprite's x position
  */
-uint16_t GBC_Graphics_oam_get_sprite_x(GBC_Graphics *self, uint8_t sprite_num);
+uint16_t GBC_Graphics_oam_get_sprite_x(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the y position of the sprite
@@ -1009,7 +1740,7 @@ uint16_t GBC_Graphics_oam_get_sprite_x(GBC_Graphics *self, uint8_t sprite_num);
  * 
  * @return The sprite's y position
  */
-uint16_t GBC_Graphics_oam_get_sprite_y(GBC_Graphics *self, uint8_t sprite_num);
+uint16_t GBC_Graphics_oam_get_sprite_y(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the tile of the sprite
@@ -1019,7 +1750,7 @@ uint16_t GBC_Graphics_oam_get_sprite_y(GBC_Graphics *self, uint8_t sprite_num);
  * 
  * @return The sprite's tile
  */
-uint8_t GBC_Graphics_oam_get_sprite_tile(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_tile(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the attributes of the sprite
@@ -1029,7 +1760,7 @@ uint8_t GBC_Graphics_oam_get_sprite_tile(GBC_Graphics *self, uint8_t sprite_num)
  * 
  * @return The sprite's attributes
  */
-uint8_t GBC_Graphics_oam_get_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the width of the sprite in pixels
@@ -1039,7 +1770,7 @@ uint8_t GBC_Graphics_oam_get_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num
  * 
  * @return The sprite's width value
  */
-uint8_t GBC_Graphics_oam_get_sprite_width(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_width(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the height of the sprite in pixels
@@ -1049,7 +1780,7 @@ uint8_t GBC_Graphics_oam_get_sprite_width(GBC_Graphics *self, uint8_t sprite_num
  * 
  * @return The sprite's height value
  */
-uint8_t GBC_Graphics_oam_get_sprite_height(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_height(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the mosaic x of the sprite in pixels
@@ -1059,7 +1790,7 @@ uint8_t GBC_Graphics_oam_get_sprite_height(GBC_Graphics *self, uint8_t sprite_nu
  * 
  * @return The sprite's mosaic x in pixels
  */
-uint8_t GBC_Graphics_oam_get_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_mosaic_x(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Gets the mosaic y of the sprite in pixels
@@ -1069,7 +1800,27 @@ uint8_t GBC_Graphics_oam_get_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_
  * 
  * @return The sprite's mosaic y in pixels
  */
-uint8_t GBC_Graphics_oam_get_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_num);
+uint8_t GBC_Graphics_oam_get_sprite_mosaic_y(GBC_Graphics *self, uint16_t sprite_num);
+
+/**
+ * Checks if the sprite is affine
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * 
+ * @return True if the sprite is affine
+ */
+bool GBC_Graphics_oam_is_sprite_affine(GBC_Graphics *self, uint16_t sprite_num);
+
+/**
+ * Gets the affine matrix number of the sprite
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * 
+ * @return The sprite's affine matrix number, from 0 to 15
+ */
+uint8_t GBC_Graphics_oam_get_sprite_affine_matrix(GBC_Graphics *self, uint16_t sprite_num);
 
 /**
  * Creates and sets a sprite in OAM with the given values
@@ -1085,7 +1836,7 @@ uint8_t GBC_Graphics_oam_get_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_
  * @param mosaic_x The sprite's mosaic x
  * @param mosaix_y The sprite's mosaic y
  */
-void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint8_t sprite_num, uint16_t x, uint16_t y, uint8_t tile_position, uint8_t attributes, uint8_t width, uint8_t height, uint8_t mosaic_x, uint8_t mosaic_y);
+void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint16_t sprite_num, uint16_t x, uint16_t y, uint8_t tile_position, uint8_t attributes, uint8_t width, uint8_t height, uint8_t mosaic_x, uint8_t mosaic_y);
 
 
 /**
@@ -1096,7 +1847,7 @@ void GBC_Graphics_oam_set_sprite(GBC_Graphics *self, uint8_t sprite_num, uint16_
  * @param dx The delta x to move the sprite by
  * @param dy The delta y to move the sprite by
  */
-void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint8_t sprite_num, short dx, short dy);
+void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint16_t sprite_num, short dx, short dy);
 
 /**
  * Sets the sprite's x position
@@ -1105,7 +1856,7 @@ void GBC_Graphics_oam_move_sprite(GBC_Graphics *self, uint8_t sprite_num, short
  * @param sprite_num The sprite's position in OAM
  * @param x The x position to move the sprite to
  */
-void GBC_Graphics_oam_set_sprite_x(GBC_Graphics *self, uint8_t sprite_num, uint16_t x);
+void GBC_Graphics_oam_set_sprite_x(GBC_Graphics *self, uint16_t sprite_num, uint16_t x);
 
 /**
  * Sets the sprite's y position
@@ -1114,7 +1865,7 @@ void GBC_Graphics_oam_set_sprite_x(GBC_Graphics *self, uint8_t sprite_num, uint1
  * @param sprite_num The sprite's position in OAM
  * @param y The y position to move the sprite to
  */
-void GBC_Graphics_oam_set_sprite_y(GBC_Graphics *self, uint8_t sprite_num, uint16_t y);
+void GBC_Graphics_oam_set_sprite_y(GBC_Graphics *self, uint16_t sprite_num, uint16_t y);
 
 /**
  * Sets the sprite's x and y position
@@ -1124,7 +1875,7 @@ void GBC_Graphics_oam_set_sprite_y(GBC_Graphics *self, uint8_t sprite_num, uint1
  * @param x The x position to move the sprite to
  * @param y The y position to move the sprite to
  */
-void GBC_Graphics_oam_set_sprite_pos(GBC_Graphics *self, uint8_t sprite_num, uint16_t x, uint16_t y);
+void GBC_Graphics_oam_set_sprite_pos(GBC_Graphics *self, uint16_t sprite_num, uint16_t x, uint16_t y);
 
 /**
  * Sets the tile position in VRAM that the sprite will use to render
@@ -1133,7 +1884,7 @@ void GBC_Graphics_oam_set_sprite_pos(GBC_Graphics *self, uint8_t sprite_num, uin
  * @param sprite_num The sprite's position in OAM
  * @param tile_position The new tile position
  */
-void GBC_Graphics_oam_set_sprite_tile(GBC_Graphics *self, uint8_t sprite_num, uint8_t tile_position);
+void GBC_Graphics_oam_set_sprite_tile(GBC_Graphics *self, uint16_t sprite_num, uint8_t tile_position);
 
 /**
  * Sets the tile position in VRAM that the sprite will use to render
@@ -1142,7 +1893,7 @@ void GBC_Graphics_oam_set_sprite_tile(GBC_Graphics *self, uint8_t sprite_num, ui
  * @param sprite_num The sprite's position in OAM
  * @param tile_position The new tile position
  */
-void GBC_Graphics_oam_set_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num, uint8_t attributes);
+void GBC_Graphics_oam_set_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num, uint8_t attributes);
 
 /**
  * Sets the palette to be used by the sprite
@@ -1151,7 +1902,7 @@ void GBC_Graphics_oam_set_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num, u
  * @param sprite_num The sprite's position in OAM
  * @param palette The number of the palette to use, 0-7
  */
-void GBC_Graphics_oam_set_sprite_palette(GBC_Graphics *self, uint8_t sprite_num, uint8_t palette);
+void GBC_Graphics_oam_set_sprite_palette(GBC_Graphics *self, uint16_t sprite_num, uint8_t palette);
 
 /**
  * Sets the VRAM bank to be used by the sprite
@@ -1160,7 +1911,7 @@ void GBC_Graphics_oam_set_sprite_palette(GBC_Graphics *self, uint8_t sprite_num,
  * @param sprite_num The sprite's position in OAM
  * @param vram_bank The VRAM bank to use, 0-3
  */
-void GBC_Graphics_oam_set_sprite_vram_bank(GBC_Graphics *self, uint8_t sprite_num, uint8_t vram_bank);
+void GBC_Graphics_oam_set_sprite_vram_bank(GBC_Graphics *self, uint16_t sprite_num, uint8_t vram_bank);
 
 /**
  * Sets the sprite's horizontal flip bit
@@ -1169,7 +1920,7 @@ void GBC_Graphics_oam_set_sprite_vram_bank(GBC_Graphics *self, uint8_t sprite_nu
  * @param sprite_num The sprite's position in OAM
  * @param flipped Should the sprite be flipped horizontally?
  */
-void GBC_Graphics_oam_set_sprite_x_flip(GBC_Graphics *self, uint8_t sprite_num, bool flipped);
+void GBC_Graphics_oam_set_sprite_x_flip(GBC_Graphics *self, uint16_t sprite_num, bool flipped);
 
 /**
  * Sets the sprite's vertical flip bit
@@ -1178,7 +1929,7 @@ void GBC_Graphics_oam_set_sprite_x_flip(GBC_Graphics *self, uint8_t sprite_num,
  * @param sprite_num The sprite's position in OAM
  * @param flipped Should the sprite be flipped vertical?
  */
-void GBC_Graphics_oam_set_sprite_y_flip(GBC_Graphics *self, uint8_t sprite_num, bool flipped);
+void GBC_Graphics_oam_set_sprite_y_flip(GBC_Graphics *self, uint16_t sprite_num, bool flipped);
 /**
  * Sets the sprite's hide bit
  * 
@@ -1186,7 +1937,7 @@ void GBC_Graphics_oam_set_sprite_y_flip(GBC_Graphics *self, uint8_t sprite_num,
  * @param sprite_num The sprite's position in OAM
  * @param flipped Should the sprite be hidden?
  */
-void GBC_Graphics_oam_set_sprite_hidden(GBC_Graphics *self, uint8_t sprite_num, bool hidden);
+void GBC_Graphics_oam_set_sprite_hidden(GBC_Graphics *self, uint16_t sprite_num, bool hidden);
 
 /**
  * Sets the sprite's width (see OAM description)
@@ -1195,7 +1946,7 @@ void GBC_Graphics_oam_set_sprite_hidden(GBC_Graphics *self, uint8_t sprite_num,
  * @param sprite_num The sprite's position in OAM
  * @param width The width of the sprite (see OAM description)
  */
-void GBC_Graphics_oam_set_sprite_width(GBC_Graphics *self, uint8_t sprite_num, uint8_t width);
+void GBC_Graphics_oam_set_sprite_width(GBC_Graphics *self, uint16_t sprite_num, uint8_t width);
 
 /**
  * Sets the sprite's height (see OAM description)
@@ -1204,7 +1955,7 @@ void GBC_Graphics_oam_set_sprite_width(GBC_Graphics *self, uint8_t sprite_num, u
  * @param sprite_num The sprite's position in OAM
  * @param height The height of the sprite (see OAM description)
  */
-void GBC_Graphics_oam_set_sprite_height(GBC_Graphics *self, uint8_t sprite_num, uint8_t height);
+void GBC_Graphics_oam_set_sprite_height(GBC_Graphics *self, uint16_t sprite_num, uint8_t height);
 
 /**
  * Sets the sprite's mosaic x (see OAM description)
@@ -1213,7 +1964,7 @@ void GBC_Graphics_oam_set_sprite_height(GBC_Graphics *self, uint8_t sprite_num,
  * @param sprite_num The sprite's position in OAM
  * @param mosaic_x The mosaic x of the sprite (see OAM description)
  */
-void GBC_Graphics_oam_set_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_num, uint8_t mosaic_x);
+void GBC_Graphics_oam_set_sprite_mosaic_x(GBC_Graphics *self, uint16_t sprite_num, uint8_t mosaic_x);
 
 /**
  * Sets the sprite's mosaic y (see OAM description)
@@ -1222,7 +1973,36 @@ void GBC_Graphics_oam_set_sprite_mosaic_x(GBC_Graphics *self, uint8_t sprite_num
  * @param sprite_num The sprite's position in OAM
  * @param mosaic_y The mosaic y of the sprite (see OAM description)
  */
-void GBC_Graphics_oam_set_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_num, uint8_t mosaic_y);
+void GBC_Graphics_oam_set_sprite_mosaic_y(GBC_Graphics *self, uint16_t sprite_num, uint8_t mosaic_y);
+
+/**
+ * Sets if the sprite is affine (see OAM description)
+ * @note Affine sprites use the mosaic bits for their matrix number, so they can't be mosaic'd
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param affine Should the sprite be rotated and scaled by its affine matrix?
+ */
+void GBC_Graphics_oam_set_sprite_affine(GBC_Graphics *self, uint16_t sprite_num, bool affine);
+
+/**
+ * Sets the sprite's affine matrix number (see OAM description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param matrix_num The affine matrix for the sprite to use, from 0 to 15
+ */
+void GBC_Graphics_oam_set_sprite_affine_matrix(GBC_Graphics *self, uint16_t sprite_num, uint8_t matrix_num);
+
+/**
+ * Sets if the affine sprite's bounding box is doubled (see OAM description)
+ * The sprite is drawn centered in the box, so the box's top left moves up and left by half the sprite's size
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param double_size Should the sprite's bounding box be doubled?
+ */
+void GBC_Graphics_oam_set_sprite_double_size(GBC_Graphics *self, uint16_t sprite_num, bool double_size);
 
 /**
  * Moves a sprite from one position in OAM to another
@@ -1232,7 +2012,7 @@ void GBC_Graphics_oam_set_sprite_mosaic_y(GBC_Graphics *self, uint8_t sprite_num
  * @param target_sprite_num The OAM location to move to
  * @param copy Should the sprite be copied (preserve source) or moved (delete source)?
  */
-void GBC_Graphics_oam_change_sprite_num(GBC_Graphics *self, uint8_t source_sprite_num, uint8_t target_sprite_num, bool copy);
+void GBC_Graphics_oam_change_sprite_num(GBC_Graphics *self, uint16_t source_sprite_num, uint16_t target_sprite_num, bool copy);
 
 /**
  * Swaps two sprites in OAM
@@ -1241,7 +2021,7 @@ void GBC_Graphics_oam_change_sprite_num(GBC_Graphics *self, uint8_t source_sprit
  * @param sprite_num_1 The first sprite to swap
  * @param sprite_num_2 The second sprite to swap
  */
-void GBC_Graphics_oam_swap_sprites(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2);
+void GBC_Graphics_oam_swap_sprites(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2);
 
 /**
  * Swaps the tiles of two sprites
@@ -1250,7 +2030,7 @@ void GBC_Graphics_oam_swap_sprites(GBC_Graphics *self, uint8_t sprite_num_1, uin
  * @param sprite_num_1 The first sprite to swap
  * @param sprite_num_2 The second sprite to swap
  */
-void GBC_Graphics_oam_swap_sprite_tiles(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2);
+void GBC_Graphics_oam_swap_sprite_tiles(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2);
 
 /**
  * Swaps the attributes of two sprites
@@ -1259,7 +2039,7 @@ void GBC_Graphics_oam_swap_sprite_tiles(GBC_Graphics *self, uint8_t sprite_num_1
  * @param sprite_num_1 The first sprite to swap
  * @param sprite_num_2 The second sprite to swap
  */
-void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2);
+void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2);
 
 /**
  * Swaps the tiles and attributes of two sprites
@@ -1268,7 +2048,60 @@ void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num_1
  * @param sprite_num_1 The first sprite to swap
  * @param sprite_num_2 The second sprite to swap
  */
-void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2);
+void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2);
+
+/**
+ * Brings the sprite cache and sprite bins up to date with OAM
+ * @note Only needed after writing to the OAM buffer directly, the OAM setters do this automatically
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ */
+void GBC_Graphics_oam_sync(GBC_Graphics *self);
+
+/**
+ * Sets the max number of sprites that will be rendered on one line, like the GBC's 10 sprite limit
+ * When more sprites overlap a line, the ones earliest in OAM are kept and the rest are dropped
+ * @note Limiting sprites per line puts a ceiling on the cost of rendering a line
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param limit The max number of sprites per line, 0 for no limit (default)
+ */
+void GBC_Graphics_oam_set_sprite_line_limit(GBC_Graphics *self, uint8_t limit);
+
+/**
+ * Sets if the sprites dropped by the line limit should rotate every frame
+ * Rather than always dropping the sprites latest in OAM, the selection starts further into
+ * the line's sprites each frame, so every sprite flickers instead of some disappearing
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param enabled Should sprite flicker be enabled?
+ */
+void GBC_Graphics_oam_set_sprite_flicker_enabled(GBC_Graphics *self, bool enabled);
+
+/**
+ * Sets the values of a sprite affine matrix (see the affine matrix description)
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param matrix_num The affine matrix to set, from 0 to 15
+ * @param pa The change in sprite x per screen x, in 8.8 fixed point
+ * @param pb The change in sprite x per screen y, in 8.8 fixed point
+ * @param pc The change in sprite y per screen x, in 8.8 fixed point
+ * @param pd The change in sprite y per screen y, in 8.8 fixed point
+ */
+void GBC_Graphics_oam_set_affine_matrix(GBC_Graphics *self, uint8_t matrix_num, int16_t pa, int16_t pb, int16_t pc, int16_t pd);
+
+/**
+ * Sets a sprite affine matrix to rotate and scale sprites around their centers
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param matrix_num The affine matrix to set, from 0 to 15
+ * @param angle The clockwise rotation, from 0 to TRIG_MAX_ANGLE
+ * @param scale_x The horizontal scale in 8.8 fixed point, GBC_AFFINE_ONE for no scaling, negative to mirror,
+ *                and kept at least GBC_AFFINE_SCALE_MIN either way around
+ * @param scale_y The vertical scale in 8.8 fixed point, GBC_AFFINE_ONE for no scaling, negative to mirror,
+ *                and kept at least GBC_AFFINE_SCALE_MIN either way around
+ */
+void GBC_Graphics_oam_set_affine_rotation_scale(GBC_Graphics *self, uint8_t matrix_num, int32_t angle, int16_t scale_x, int16_t scale_y);
 
 /**
  * Copies the data in one background tilemap and attrmap to 
@@ -1278,4 +2111,247 @@ void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint8_t sp
  * @param source_bg_layer The number of the source background layer, from 0 to 3
  * @param target_bg_layer The number of the source background layer, from 0 to 3
 */
-void GBC_Graphics_copy_background(GBC_Graphics *self, uint8_t source_bg_layer, uint8_t target_bg_layer);
\ No newline at end of file
+void GBC_Graphics_copy_background(GBC_Graphics *self, uint8_t source_bg_layer, uint8_t target_bg_layer);
+
+/**
+ * Gets the size of a snapshot of the object's current state
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param subsystems The parts of the state to save, see the snapshot flags
+ * 
+ * @return The size of the snapshot in bytes, including its header
+ */
+size_t GBC_Graphics_snapshot_get_size(GBC_Graphics *self, uint8_t subsystems);
+
+/**
+ * Saves parts of the object's state into a snapshot, to restore later with GBC_Graphics_snapshot_restore
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param subsystems The parts of the state to save, see the snapshot flags
+ * @param buffer A pointer to where the snapshot will be stored, which needs to be 4 byte aligned
+ * @param buffer_size The size of the buffer in bytes
+ * 
+ * @return The size of the snapshot in bytes, or 0 if it doesn't fit in the buffer
+ */
+size_t GBC_Graphics_snapshot_save(GBC_Graphics *self, uint8_t subsystems, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Restores the parts of the object's state held by a snapshot
+ * The sprite cache is rebuilt if OAM was restored, and the cached backgrounds are refreshed on the next frame
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param snapshot A pointer to the snapshot, from GBC_Graphics_snapshot_save
+ * 
+ * @return true if the snapshot was restored, false if it's not a snapshot or was taken from a different layout of object
+ */
+bool GBC_Graphics_snapshot_restore(GBC_Graphics *self, const uint8_t *snapshot);
+
+/**
+ * Saves the difference between the object's current state and a base snapshot, as runs of changed bytes
+ * Scenes that share most of their state with the base take a fraction of a full snapshot
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param base A pointer to the base snapshot, from GBC_Graphics_snapshot_save, with the parts of the state to save
+ * @param buffer A pointer to where the delta snapshot will be stored, which needs to be 4 byte aligned
+ * @param buffer_size The size of the buffer in bytes
+ * 
+ * @return The size of the delta snapshot in bytes, or 0 if it doesn't fit in the buffer or the base doesn't match the object
+ */
+size_t GBC_Graphics_snapshot_save_delta(GBC_Graphics *self, const uint8_t *base, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Restores the state saved by a delta snapshot, by restoring its base snapshot and then applying the changes
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param base A pointer to the base snapshot that the delta snapshot was saved against
+ * @param delta A pointer to the delta snapshot, from GBC_Graphics_snapshot_save_delta
+ * 
+ * @return true if the delta snapshot was restored, false if either snapshot doesn't match the object
+ */
+bool GBC_Graphics_snapshot_restore_delta(GBC_Graphics *self, const uint8_t *base, const uint8_t *delta);
+
+/**
+ * Writes a snapshot or delta snapshot to persistent storage, split across consecutive keys
+ * 
+ * @param snapshot A pointer to the snapshot
+ * @param first_key The persistent storage key of the first PERSIST_DATA_MAX_LENGTH bytes, the rest use the keys after it
+ * 
+ * @return The number of keys written, or a negative status code if writing failed
+ * @note Apps only get a few kilobytes of persistent storage, so persist delta snapshots or only the parts of the state that are needed
+ */
+int GBC_Graphics_snapshot_persist(const uint8_t *snapshot, uint32_t first_key);
+
+/**
+ * Reads a snapshot or delta snapshot back from persistent storage, written by GBC_Graphics_snapshot_persist
+ * 
+ * @param first_key The persistent storage key the snapshot was written to
+ * @param buffer A pointer to where the snapshot will be stored, which needs to be 4 byte aligned
+ * @param buffer_size The size of the buffer in bytes
+ * 
+ * @return The size of the snapshot in bytes, or 0 if there's no snapshot or it doesn't fit in the buffer
+ */
+size_t GBC_Graphics_snapshot_load_persisted(uint32_t first_key, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Sets the collision flags of a tile in VRAM, which the collision queries check the backgrounds against
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param tile_number The tile's number, from 0 to num_vram_banks * 256 - 1 (vram_bank * 256 + tile_position)
+ * @param flags The tile's collision flags, defined by the app, 0 for a tile that doesn't collide
+ * @note The flags table takes a byte per tile in VRAM, and is allocated when the first tile's flags are set
+ */
+void GBC_Graphics_collision_set_tile_flags(GBC_Graphics *self, uint16_t tile_number, uint8_t flags);
+
+/**
+ * Sets the collision flags of a run of tiles in VRAM, e.g. from a table loaded with the tilesheet
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param first_tile_number The number of the first tile, from 0 to num_vram_banks * 256 - 1
+ * @param flags_array A pointer to the tiles' collision flags, one byte per tile
+ * @param num_tiles The number of tiles to set
+ */
+void GBC_Graphics_collision_set_tile_flags_array(GBC_Graphics *self, uint16_t first_tile_number, const uint8_t *flags_array, uint16_t num_tiles);
+
+/**
+ * Gets the collision flags of a tile in VRAM
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param tile_number The tile's number, from 0 to num_vram_banks * 256 - 1
+ * 
+ * @return The tile's collision flags
+ */
+uint8_t GBC_Graphics_collision_get_tile_flags(GBC_Graphics *self, uint16_t tile_number);
+
+/**
+ * Gets the collision flags of the tile at a position on a background's map
+ * Hidden tiles aren't drawn, so they don't collide
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The background layer to check, from 0 to 3
+ * @param x The x position of the tile on the map, from 0 to the map's width - 1
+ * @param y The y position of the tile on the map, from 0 to the map's height - 1
+ * 
+ * @return The collision flags of the tile at that position
+ */
+uint8_t GBC_Graphics_collision_get_map_flags(GBC_Graphics *self, uint8_t bg_layer, uint8_t x, uint8_t y);
+
+/**
+ * Checks which collision flags the tiles of a background under a rectangle of the screen have, 
+ * e.g. to see if a sprite's bounding box is touching a wall
+ * The rectangle is in the same coordinates as sprites (relative to the screen origin, without the sprite offset),
+ * and goes through the background's scroll position and wraps around its map the way it's drawn. Affine backgrounds are
+ * checked at their scroll position, not through their affine parameters
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The background layer to check, from 0 to 3
+ * @param rect The rectangle to check
+ * 
+ * @return The collision flags of every tile under the rectangle OR'd together, 0 if none of them collide
+ */
+uint8_t GBC_Graphics_collision_check_rect(GBC_Graphics *self, uint8_t bg_layer, GRect rect);
+
+/**
+ * Steps along a line across a background, and finds the first pixel on a tile with any of the given collision flags,
+ * e.g. for line of sight, or to find the ground below a falling sprite
+ * The line is in the same coordinates as sprites, and goes through the background's scroll position like GBC_Graphics_collision_check_rect
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param bg_layer The background layer to check, from 0 to 3
+ * @param from The start of the line, which is checked too
+ * @param to The end of the line
+ * @param flags The collision flags to stop at
+ * @param hit A pointer to where the first pixel on a colliding tile will be stored, or NULL
+ * 
+ * @return true if the line reached a tile with any of the flags, false if the whole line is clear
+ */
+bool GBC_Graphics_collision_cast_ray(GBC_Graphics *self, uint8_t bg_layer, GPoint from, GPoint to, uint8_t flags, GPoint *hit);
+
+/**
+ * Finds every pair of sprites whose bounding boxes overlap, using the decoded sprites
+ * The sprites are sorted by their left edge and swept across the screen, so each sprite is only checked against
+ * the sprites that start before its right edge. Hidden sprites and sprites entirely off the screen are skipped
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param pairs A pointer to where the pairs will be stored, two sprite numbers per pair with the lower one first
+ * @param max_pairs The number of pairs that fit in the pairs array
+ * 
+ * @return The number of pairs found, up to max_pairs
+ * @note This uses the renderer's scratch sprite list, so call it between frames or from the VBlank callback
+ */
+uint16_t GBC_Graphics_collision_find_sprite_pairs(GBC_Graphics *self, uint16_t *pairs, uint16_t max_pairs);
+
+/**
+ * Enables or disables the tile masks (see the tile masks description), which make the sprite collision checks pixel precise
+ * The masks are built from all of VRAM when enabled, and then rebuilt for the tiles that are loaded or moved
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param enabled Should the tile masks be kept?
+ * @note The masks take 2KB per VRAM bank
+ */
+void GBC_Graphics_collision_set_tile_masks_enabled(GBC_Graphics *self, bool enabled);
+
+/**
+ * Rebuilds the masks of a run of tiles, after writing to VRAM directly
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param first_tile_number The number of the first tile, from 0 to num_vram_banks * 256 - 1 (vram_bank * 256 + tile_position)
+ * @param num_tiles The number of tiles to rebuild
+ */
+void GBC_Graphics_collision_update_tile_masks(GBC_Graphics *self, uint16_t first_tile_number, uint16_t num_tiles);
+
+/**
+ * Checks if two sprites overlap, comparing the masks of their tiles row by row where their bounding boxes overlap,
+ * so only the pixels that are drawn collide. Flips and multi-tile sprites are matched to how the sprites are drawn,
+ * affine sprites are solid across their bounding box, and mosaic is ignored
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num_1 The position in OAM of the first sprite
+ * @param sprite_num_2 The position in OAM of the second sprite
+ * 
+ * @return true if the sprites overlap, or if their bounding boxes overlap while the tile masks are disabled
+ * @note Check the pairs from GBC_Graphics_collision_find_sprite_pairs, so only sprites with overlapping bounding boxes are compared
+ */
+bool GBC_Graphics_collision_check_sprites(GBC_Graphics *self, uint16_t sprite_num_1, uint16_t sprite_num_2);
+
+/**
+ * Checks which tiles of a background a sprite's pixels overlap, comparing the sprite's masks against the masks of the tiles
+ * with any of the given collision flags. The background goes through its scroll position like GBC_Graphics_collision_check_rect
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The sprite's position in OAM
+ * @param bg_layer The background layer to check, from 0 to 3
+ * @param flags The collision flags of the tiles to check against
+ * 
+ * @return The collision flags of the tiles the sprite overlaps OR'd together, only including the given flags.
+ *         With the tile masks disabled every tile and sprite is solid, like GBC_Graphics_collision_check_rect
+ */
+uint8_t GBC_Graphics_collision_check_sprite_bg(GBC_Graphics *self, uint16_t sprite_num, uint8_t bg_layer, uint8_t flags);
+
+/**
+ * Writes a metasprite's parts to consecutive sprites in OAM, placed around the metasprite's origin. Animate it by
+ * calling this again with another frame's metasprite or tile position. When flipped, the parts' offsets are mirrored
+ * around the origin and each part is flipped as well, so put the origin at the character's center for it to flip in place
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The position in OAM of the first sprite to use
+ * @param num_sprites The number of sprites set aside for the metasprite, any not used by its parts are hidden
+ * @param metasprite A pointer to the metasprite to write
+ * @param x The x position of the metasprite's origin, like a sprite's x position
+ * @param y The y position of the metasprite's origin, like a sprite's y position
+ * @param tile_position The tile position in VRAM that the parts' tile offsets start from
+ * @param attributes The metasprite's attributes, the flip flags flip the whole metasprite and the hide flag hides it
+ * @note Parts past num_sprites or the end of OAM are left out, and the origin is clamped so every part fits in the sprite positions
+ */
+void GBC_Graphics_metasprite_set(GBC_Graphics *self, uint16_t sprite_num, uint8_t num_sprites, const GBC_Metasprite *metasprite, short x, short y, uint8_t tile_position, uint8_t attributes);
+
+/**
+ * Moves all the sprites of a metasprite by dx and dy, stopping short where any of them would go past the sprite positions
+ * so the parts keep their layout
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param sprite_num The position in OAM of the metasprite's first sprite
+ * @param num_sprites The number of sprites set aside for the metasprite
+ * @param dx The delta x to move the metasprite by
+ * @param dy The delta y to move the metasprite by
+ */
+void GBC_Graphics_metasprite_move(GBC_Graphics *self, uint16_t sprite_num, uint8_t num_sprites, short dx, short dy);
\ No newline at end of file
@@ -42,6 +42,10 @@ GBC_Graphics *GBC_Graphics_ctor(Window *window, uint8_t num_vram_banks) {
     self->lcdc = 0xFF; // Start LCDC with everything enable (render everything)
     self->stat = 0x00; // Start STAT empty
 
+    self->sprite_line_limit = 0; // Start with no limit on sprites per line
+    self->sprite_flicker_enabled = false;
+    self->sprite_flicker_offset = 0;
+
     return self;
 }
 
@@ -240,6 +244,141 @@ static void modify_byte(uint8_t *byte, uint8_t mask, uint8_t new_value, uint8_t
     *byte = (*byte & ~mask) | new_value * byte_start;
 }
 
+/**
+ * Drops sprites from a line's overlapped sprite list until it fits within the line limit
+ * The list is in reverse OAM order, so sprites are kept counting back from the end of the list,
+ * starting at the rotation and wrapping around, and the kept sprites stay in their original order
+ * 
+ * @param sprite_list The ids of the sprites on the line, in reverse OAM order
+ * @param num_sprites The number of sprites in the list
+ * @param limit The max number of sprites to keep
+ * @param rotation How far into the line's sprites (in OAM order) to start keeping sprites
+ * 
+ * @return The number of sprites left in the list
+ */
+static uint8_t limit_sprites_on_line(uint8_t *sprite_list, uint8_t num_sprites, uint8_t limit, uint8_t rotation) {
+    uint8_t start = rotation % num_sprites;
+    uint8_t num_kept = 0;
+    uint8_t oam_order, rank;
+    for (uint8_t i = 0; i < num_sprites; i++) {
+        oam_order = num_sprites - 1 - i;
+        rank = oam_order >= start ? oam_order - start : oam_order + num_sprites - start; // Position of the sprite counting from start
+        sprite_list[num_kept] = sprite_list[i];
+        num_kept += rank < limit;
+    }
+    return num_kept;
+}
+
+#if defined(PBL_BW)
+/**
+ * Packs the even bits of a tile row into a byte, pulling one bit plane out of the row's 2bpp pixels
+ * 
+ * @param row The two bytes of the tile row, shifted right by 1 for the high bits
+ * 
+ * @return One bit per pixel, with the leftmost pixel in the top bit
+ */
+static uint8_t compress_even_bits(uint16_t row) {
+    row &= 0x5555;
+    row = (row | (row >> 1)) & 0x3333;
+    row = (row | (row >> 2)) & 0x0F0F;
+    row = (row | (row >> 4)) & 0x00FF;
+    return row;
+}
+
+/**
+ * Reverses the order of the bits in a byte
+ * 
+ * @param byte The byte to reverse
+ * 
+ * @return The reversed byte
+ */
+static uint8_t reverse_bits(uint8_t byte) {
+    byte = ((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4);
+    byte = ((byte & 0xCC) >> 2) | ((byte & 0x33) << 2);
+    byte = ((byte & 0xAA) >> 1) | ((byte & 0x55) << 1);
+    return byte;
+}
+
+/**
+ * Draws a span of the background or window on a black and white line, one tile row at a time
+ * Each tile row is turned into a white mask and a gray mask using the line's palette masks,
+ * and the 8 dithered pixels are written into the framebuffer with at most two byte writes
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param row_data The framebuffer data for the line
+ * @param start_x The screen x to start drawing at
+ * @param end_x The screen x to stop drawing at (exclusive)
+ * @param map_x The map x of the pixel at start_x
+ * @param map_y The map y of the line
+ * @param tilemap The tilemap to draw from
+ * @param attrmap The attrmap to draw from
+ * @param white_masks 0xFF for each bg palette color that draws as white, 0x00 otherwise
+ * @param gray_masks 0xFF for each bg palette color that draws as gray, 0x00 otherwise
+ */
+static void render_bw_span(GBC_Graphics *self, uint8_t *row_data, uint8_t start_x, uint8_t end_x, uint8_t map_x, uint8_t map_y,
+                           uint8_t *tilemap, uint8_t *attrmap, uint8_t *white_masks, uint8_t *gray_masks) {
+    uint8_t map_tile_y = map_y >> 3; // map_y / GBC_TILE_HEIGHT
+    uint8_t pixel_y = map_y & 7; // map_y % GBC_TILE_HEIGHT
+    uint8_t tile_num, tile_attr, row, high, low, white, gray, pixels, mask;
+    uint8_t *tile, *palette_white, *palette_gray;
+    uint16_t offset, wide_mask, wide_pixels;
+    short byte;
+
+    if (start_x >= end_x) {
+        return;
+    }
+
+    // Start at the left edge of the tile under start_x, which may be off the left of the span
+    for (short x = start_x - (map_x & 7); x < end_x; x += GBC_TILE_WIDTH, map_x += GBC_TILE_WIDTH) {
+        offset = (map_x >> 3) + (map_tile_y << 5); // map_tile_x + map_tile_y * MAP_WIDTH
+        tile_num = tilemap[offset];
+        tile_attr = attrmap[offset];
+        tile = self->vram + ((((tile_attr & GBC_ATTR_VRAM_BANK_MASK) >> 3)) << 12) + (tile_num << 4);
+
+        // Grab the whole row, and split its 2 bit pixels into a high bit plane and a low bit plane
+        row = (tile_attr & GBC_ATTR_FLIP_FLAG_Y) ? 7 - pixel_y : pixel_y;
+        offset = (tile[row << 1] << 8) | tile[(row << 1) + 1];
+        high = compress_even_bits(offset >> 1);
+        low = compress_even_bits(offset);
+
+        // Pick out the pixels of each palette color, keeping the ones that draw as white or gray
+        palette_white = &white_masks[(tile_attr & GBC_ATTR_PALETTE_MASK) << 2];
+        palette_gray = &gray_masks[(tile_attr & GBC_ATTR_PALETTE_MASK) << 2];
+        white = (~high & ~low & palette_white[0]) | (~high & low & palette_white[1]) | (high & ~low & palette_white[2]) | (high & low & palette_white[3]);
+        gray = (~high & ~low & palette_gray[0]) | (~high & low & palette_gray[1]) | (high & ~low & palette_gray[2]) | (high & low & palette_gray[3]);
+
+        // The framebuffer keeps the leftmost pixel in the lowest bit, which an x flipped tile already has
+        if (!(tile_attr & GBC_ATTR_FLIP_FLAG_X)) {
+            white = reverse_bits(white);
+            gray = reverse_bits(gray);
+        }
+
+        // Gray is a checkerboard, drawn white where the screen x + line y is odd
+        pixels = white | (gray & (((x + self->line_y) & 1) ? 0x55 : 0xAA));
+
+        // Clip the tile to the span
+        mask = 0xFF;
+        if (x < start_x) {
+            mask &= 0xFF << (start_x - x);
+        }
+        if (x + GBC_TILE_WIDTH > end_x) {
+            mask &= 0xFF >> (x + GBC_TILE_WIDTH - end_x);
+        }
+
+        // Write the pixels over the one or two bytes they land on
+        byte = ((x + GBC_TILE_WIDTH) >> 3) - 1; // x / 8, rounding down when x is negative
+        wide_mask = mask << (x & 7);
+        wide_pixels = (pixels & mask) << (x & 7);
+        if (wide_mask & 0xFF) {
+            row_data[byte] = (row_data[byte] & ~wide_mask) | wide_pixels;
+        }
+        if (wide_mask >> 8) {
+            row_data[byte + 1] = (row_data[byte + 1] & ~(wide_mask >> 8)) | (wide_pixels >> 8);
+        }
+    }
+}
+#endif
+
 /**
  * Renders the background and window, called from an update proc
  * 
@@ -258,17 +397,17 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
     uint8_t window_offset_x = clamp_short_to_uint8_t(self->window_offset_x, 0, self->screen_width);
 
     // Predefine the variables we'll use in the loop
-    uint8_t map_x, map_y, map_tile_x, map_tile_y, tile_num, tile_attr;
+    uint8_t map_x, map_y, map_tile_x, map_tile_y;
     uint8_t *tilemap, *attrmap;
     uint16_t offset;
     uint8_t *tile;
     uint8_t pixel_x, pixel_y, pixel_byte, pixel_color, pixel;
     uint8_t shift;
-    uint8_t x;
     uint8_t flip;
     bool in_window_y;
     
     short screen_x, screen_y;
+    short sprite_x, sprite_min_x, sprite_max_x;
     uint8_t tile_x, tile_y;
     uint8_t bg_tile_num, bg_tile_attr;
     uint8_t *sprite, *bg_tile;
@@ -278,6 +417,13 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
     uint8_t i;
     uint8_t sprite_y;
     short sprite_id;
+#if defined(PBL_BW)
+    uint8_t white_masks[GBC_PALETTE_BANK_NUM_BYTES], gray_masks[GBC_PALETTE_BANK_NUM_BYTES];
+    uint8_t window_start_x;
+#else
+    uint8_t tile_num, tile_attr;
+    uint8_t x;
+#endif
 
     self->stat &= ~GBC_STAT_VBLANK_FLAG; // No longer in VBlank while we draw
     for (self->line_y = 0; self->line_y < self->screen_height; self->line_y++) {
@@ -296,6 +442,21 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
 
         self->stat &= ~GBC_STAT_HBLANK_FLAG; // No longer in HBlank while we draw the line
         // First, draw the background / window
+    #if defined(PBL_BW)
+        // Black and white draws whole tile rows at a time, so find which palette colors come out white or gray
+        for (i = 0; i < GBC_PALETTE_BANK_NUM_BYTES; i++) {
+            pixel_color = self->bg_palette_bank[i];
+            white_masks[i] = -((pixel_color >> 1) & pixel_color & 1);
+            gray_masks[i] = -((pixel_color >> 1) & ~pixel_color & 1);
+        }
+
+        // Then split the line where the window starts, and draw the background and window spans
+        window_start_x = in_window_y ? GBC_MAX(GBC_MIN(self->screen_x_origin + window_offset_x, max_x), min_x) : max_x;
+        render_bw_span(self, info.data, min_x, window_start_x, (min_x - self->screen_x_origin) + self->bg_scroll_x, self->line_y + self->bg_scroll_y,
+                       self->bg_tilemap, self->bg_attrmap, white_masks, gray_masks);
+        render_bw_span(self, info.data, window_start_x, max_x, (window_start_x - self->screen_x_origin) - self->window_offset_x, self->line_y - self->window_offset_y,
+                       self->window_tilemap, self->window_attrmap, white_masks, gray_masks);
+    #else
         for(x = min_x; x < max_x; x++) {
             // Decide what pixel to draw, first check if we're in the window bounds
             if (in_window_y && (x - self->screen_x_origin) >= window_offset_x) {
@@ -347,35 +508,34 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
             // Finally, we get the corresponding color from attribute palette
             pixel_color = self->bg_palette_bank[((tile_attr & GBC_ATTR_PALETTE_MASK) << 2) + pixel]; // (tile_attr & GBC_ATTR_PALETTE_MASK) * 4
 
-        #if defined(PBL_COLOR)
             memset(&info.data[x], pixel_color, 1);
-        #else
-            pixel_color = (pixel_color >> 1) & ((pixel_color & 1) | ((x + self->line_y) & 0b11));
-            uint16_t byte = (x >> 3); // x / 8
-            uint8_t bit = x & 7; // x % 8
-            uint8_t *byte_mod = &info.data[byte];
-            *byte_mod ^= (-pixel_color ^ *byte_mod) & (1 << bit);
-        #endif
         }
+    #endif
 
-        // Next, draw any sprites that happen to be on this line
+        // Next, draw any sprites that happen to be on this line, but only inside its visible span [min, max) (the circle on round Pebbles)
+        sprite_min_x = GBC_MAX(info.min_x, self->screen_x_origin);
+        sprite_max_x = GBC_MIN(info.max_x + 1, self->screen_x_origin + self->screen_width);
         num_overlapped_sprites = 0;
         for (sprite_id = 39 * ((self->lcdc & GBC_LCDC_SPRITE_ENABLE_FLAG) > 0); sprite_id >= 0; sprite_id--) {
             sprite = &self->oam[sprite_id*4];
             sprite_y = sprite[1] - GBC_SPRITE_OFFSET_Y;
             line_overlap = ((uint8_t)(self->line_y - sprite_y)) < (GBC_TILE_HEIGHT << ((self->lcdc & GBC_LCDC_SPRITE_SIZE_FLAG) > 0));
+            // Don't count the sprite if it's offscreen or outside the visible span, so it doesn't use up the line limit
+            line_overlap = line_overlap && !(sprite[0] == 0 || sprite[1] == 0 || sprite[0] >= self->screen_width + GBC_SPRITE_OFFSET_X || sprite[1] >= self->screen_height + GBC_SPRITE_OFFSET_Y);
+            sprite_x = sprite[0] - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
+            line_overlap = line_overlap && sprite_x < sprite_max_x && (sprite_x + GBC_TILE_WIDTH) > sprite_min_x;
             
             overlapped_sprites[num_overlapped_sprites] = sprite_id * line_overlap;
             num_overlapped_sprites += line_overlap;
         }
 
+        // Keep the sprite count within the line limit
+        if (self->sprite_line_limit != 0 && num_overlapped_sprites > self->sprite_line_limit) {
+            num_overlapped_sprites = limit_sprites_on_line(overlapped_sprites, num_overlapped_sprites, self->sprite_line_limit, self->sprite_flicker_offset);
+        }
+
         for (i = 0; i < num_overlapped_sprites; i++) {
             sprite = &self->oam[overlapped_sprites[i]*4];
-            sprite_y = sprite[1] - GBC_SPRITE_OFFSET_Y;
-            // Don't draw the sprite if it's offscreen
-            if (sprite[0] == 0 || sprite[1] == 0 || sprite[0] >= self->screen_width + GBC_SPRITE_OFFSET_X || sprite[1] >= self->screen_height + GBC_SPRITE_OFFSET_Y) {
-                continue;
-            }
 
             // Get the tile from vram
             offset = sprite[2] << 4; // tile_num * GBC_TILE_NUM_BYTES
@@ -386,18 +546,10 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
             tile_y = self->line_y - sprite_y;
             screen_y = sprite[1] + tile_y - GBC_SPRITE_OFFSET_Y; // On second tile, offset by GBC_TILE_HEIGHT
 
-            uint8_t min_x = GBC_MAX(info.min_x, self->screen_x_origin);
-            uint8_t max_x = GBC_MIN(info.max_x, self->screen_x_origin + self->screen_width);
-
-            for (tile_x = 0; tile_x < GBC_TILE_WIDTH; tile_x++) {
-                // Check if the pixel is on the screen
-                screen_x = sprite[0] + tile_x - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
-                if (screen_x > max_x) {
-                    break;
-                }
-                if (screen_x < min_x) {
-                    continue;
-                }
+            // Only step through the sprite's pixels that land in the visible span
+            sprite_x = sprite[0] - GBC_SPRITE_OFFSET_X + self->screen_x_origin;
+            for (tile_x = GBC_MAX(sprite_min_x - sprite_x, 0); tile_x < (GBC_MIN(sprite_max_x - sprite_x, GBC_TILE_WIDTH)); tile_x++) {
+                screen_x = sprite_x + tile_x;
                 if (in_window_y && (screen_x - self->screen_x_origin) >= window_offset_x) {
                     map_x = (screen_x - self->screen_x_origin) - self->window_offset_x;
                     map_y = screen_y - self->window_offset_y;
@@ -503,6 +655,11 @@ static void render_graphics(GBC_Graphics *self, Layer *layer, GContext *ctx) {
 
     graphics_release_frame_buffer(ctx, fb);
 
+    // Rotate the sprites kept by the line limit for the next frame
+    if (self->sprite_flicker_enabled) {
+        self->sprite_flicker_offset += self->sprite_line_limit;
+    }
+
     // Finished drawing sprites, call OAM callback
     self->stat |= GBC_STAT_OAM_FLAG;
     if (self->stat & GBC_STAT_OAM_INT_FLAG) {
@@ -953,6 +1110,14 @@ void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint8_t sp
     }
 }
 
+void GBC_Graphics_oam_set_sprite_line_limit(GBC_Graphics *self, uint8_t limit) {
+    self->sprite_line_limit = limit;
+}
+
+void GBC_Graphics_oam_set_sprite_flicker_enabled(GBC_Graphics *self, bool enabled) {
+    self->sprite_flicker_enabled = enabled;
+}
+
 void GBC_Graphics_copy_background_to_window(GBC_Graphics *self) {
     memcpy(self->window_tilemap, self->bg_tilemap, GBC_TILEMAP_NUM_BYTES);
     memcpy(self->window_attrmap, self->bg_attrmap, GBC_ATTRMAP_NUM_BYTES);
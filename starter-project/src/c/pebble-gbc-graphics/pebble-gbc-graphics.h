@@ -234,6 +234,10 @@ struct _gbc_graphics {
     uint8_t screen_y_origin; ///> The start y position of the rendered screen
     uint8_t screen_width; ///> The width of the rendered screen
     uint8_t screen_height; ///> The height of the rendered screen
+
+    uint8_t sprite_line_limit; ///> The max number of sprites rendered on one line, 0 for no limit
+    bool sprite_flicker_enabled; ///> If true, the sprites dropped by the line limit rotate every frame
+    uint8_t sprite_flicker_offset; ///> The rotation into each line's sprites when flicker is enabled - READ ONLY
 };
 
 /**
@@ -1267,6 +1271,24 @@ void GBC_Graphics_oam_swap_sprite_attrs(GBC_Graphics *self, uint8_t sprite_num_1
  */
 void GBC_Graphics_oam_swap_sprite_tiles_and_attrs(GBC_Graphics *self, uint8_t sprite_num_1, uint8_t sprite_num_2);
 
+/**
+ * Sets the max number of sprites that will be rendered on one line, like the GBC's 10 sprite limit
+ * When more sprites overlap a line, the ones earliest in OAM are kept and the rest are dropped
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param limit The max number of sprites per line, 0 for no limit (default)
+ */
+void GBC_Graphics_oam_set_sprite_line_limit(GBC_Graphics *self, uint8_t limit);
+
+/**
+ * Sets if the sprites dropped by the line limit should rotate every frame,
+ * so every sprite flickers instead of the same ones disappearing
+ * 
+ * @param self A pointer to the target GBC Graphics object
+ * @param enabled Should sprite flicker be enabled?
+ */
+void GBC_Graphics_oam_set_sprite_flicker_enabled(GBC_Graphics *self, bool enabled);
+
 /**
  * Copies the data in the background tilemap and attrmap to the
  * window tilemap and attrmap